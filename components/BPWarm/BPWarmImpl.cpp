@@ -192,6 +192,18 @@ public:
     theBranchPredictor->loadState(aDirName);
   }
 
+  bool hasFlexpointSections() const {
+    return true;
+  }
+
+  void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter) {
+    theBranchPredictor->saveFlexpoint(aWriter);
+  }
+
+  bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader) {
+    return theBranchPredictor->loadFlexpoint(aReader);
+  }
+
 public:
   ///////////////// InsnIn port
   bool available(interface::InsnIn const &, index_t anIndex) {
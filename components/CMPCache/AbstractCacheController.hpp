@@ -97,6 +97,12 @@ public:
 
   virtual void processMessages() = 0;
 
+  // Earliest cycle at which processMessages() has work.  Controllers that do
+  // not track this are driven every cycle.
+  virtual uint64_t nextEventCycle() {
+    return 0;
+  }
+
   virtual void saveState(std::string const &aDirName) = 0;
 
   virtual void loadState(std::string const &aDirName) = 0;
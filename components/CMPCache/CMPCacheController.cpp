@@ -90,7 +90,8 @@ CMPCacheController::CMPCacheController(const CMPCacheInfo &anInfo)
       theRequestInUtilization(anInfo.theName + "-RequestInUtilization"),
       theMafUtilization(anInfo.theName + "-MafUtilization"),
       theDirTagUtilization(anInfo.theName + "-DirTagUtilization"),
-      theDataUtilization(anInfo.theName + "-DataUtilization"), theIdleWorkScheduled(false) {
+      theDataUtilization(anInfo.theName + "-DataUtilization"), theIdleWorkScheduled(false),
+      theLastProcessCycle(0) {
   theMaxSnoopsPerRequest = thePolicy->maxSnoopsPerRequest();
 }
 
@@ -167,8 +168,31 @@ void CMPCacheController::loadState(std::string const &aDirName) {
   c_ifs.close();
 }
 
+uint64_t CMPCacheController::nextEventCycle() {
+  if (!RequestIn.empty() || !SnoopIn.empty() || !ReplyIn.empty() ||
+      thePolicy->MAF().hasWakingEntry() ||
+      (!thePolicy->freeCacheEBPending() && thePolicy->CacheEB().usedEntries() > 0) ||
+      (!thePolicy->freeDirEBPending() && thePolicy->DirEB().idleWorkReady()) ||
+      thePolicy->hasIdleWorkAvailable()) {
+    return 0;
+  }
+  return std::min(theMAFPipeline.nextReadyCycle(),
+                  std::min(theDirTagPipeline.nextReadyCycle(), theDataPipeline.nextReadyCycle()));
+}
+
 void CMPCacheController::processMessages() {
 
+  // Cycles skipped while idle still count towards the utilization stats
+  uint64_t now = Flexus::Core::theFlexus->cycleCount();
+  if (theLastProcessCycle > 0 && now > theLastProcessCycle + 1) {
+    int64_t skipped = now - theLastProcessCycle - 1;
+    theRequestInUtilization << std::make_pair(RequestIn.getSize(), skipped);
+    theMafUtilization << std::make_pair(theMAFPipeline.size(), skipped);
+    theDirTagUtilization << std::make_pair(theDirTagPipeline.size(), skipped);
+    theDataUtilization << std::make_pair(theDataPipeline.size(), 2 * skipped);
+  }
+  theLastProcessCycle = now;
+
   // Track utilization stats
   theRequestInUtilization << std::make_pair(RequestIn.getSize(), 1);
   theMafUtilization << std::make_pair(theMAFPipeline.size(), 1);
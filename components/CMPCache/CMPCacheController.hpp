@@ -74,6 +74,9 @@ private:
 
   int32_t theMaxSnoopsPerRequest;
 
+  // Cycle of the last processMessages() call, to account for skipped cycles
+  uint64_t theLastProcessCycle;
+
 public:
   CMPCacheController(const CMPCacheInfo &anInfo);
 
@@ -89,6 +92,8 @@ public:
 
   virtual void processMessages();
 
+  virtual uint64_t nextEventCycle();
+
   // static memembers to work with AbstractFactory
   static AbstractCacheController *
   createInstance(std::list<std::pair<std::string, std::string>> &args, const CMPCacheInfo &params);
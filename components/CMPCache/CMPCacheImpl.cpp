@@ -83,6 +83,14 @@ public:
     return theController->isQuiesced();
   }
 
+  uint64_t nextEventCycle() const {
+    if (!theController.get() || !theController->ReplyOut.empty() ||
+        !theController->SnoopOut.empty() || !theController->RequestOut.empty()) {
+      return 0;
+    }
+    return theController->nextEventCycle();
+  }
+
   void saveState(std::string const &aDirName) {
     theController->saveState(aDirName);
   }
@@ -341,6 +341,7 @@ CacheController::CacheController(
   lastRequestQueue = 0;
   lastPrefetchQueue = 0;
   theLastScheduledBank = theLastTagPipeline = theLastDataPipeline = 0;
+  theLastProcessCycle = 0;
 }
 
 // These methods are used by the Impl to manipulate the MAF
@@ -531,10 +532,66 @@ void CacheController::enqueueTagPipeline(Action action, ProcessEntry_p aProcess)
 // operations in this function is important - it is designed to make sure
 // a request can be received and processed in a single cycle for L1 cache
 // hits
+uint64_t CacheController::nextEventCycle() {
+  for (int32_t i = 0; i < theCores; i++) {
+    if (!FrontSideIn_Snoop[i].empty() || !FrontSideIn_Request[i].empty() ||
+        !FrontSideIn_Prefetch[i].empty()) {
+      return 0;
+    }
+  }
+  for (int32_t i = 0; i < theBanks; i++) {
+    if (!BankFrontSideIn_Snoop[i].empty() || !BankFrontSideIn_Request[i].empty() ||
+        !BankFrontSideIn_Prefetch[i].empty() || !BankBackSideIn_Request[i].empty() ||
+        !BankBackSideIn_Reply[i].empty()) {
+      return 0;
+    }
+  }
+  if (!BackSideIn_Reply[0].empty() || !BackSideIn_Request[0].empty() || !isWakeMAFListEmpty() ||
+      !isIProbeListEmpty() || !isFrontSideOutEmpty_I() || !isFrontSideOutEmpty_D() ||
+      !BackSideOut_Reply.empty() || !BackSideOut_Snoop.empty() || !BackSideOut_Request.empty() ||
+      !BackSideOut_Prefetch.empty() || theCacheControllerImpl->hasWakingSnoops() ||
+      theCacheControllerImpl->evictableBlockExists(theScheduledEvicts) ||
+      theCacheControllerImpl->idleWorkAvailable()) {
+    return 0;
+  }
+
+  uint64_t next = UINT64_MAX;
+  for (int32_t i = 0; i < theBanks; i++) {
+    next = std::min(next, theMAFPipeline[i].nextReadyCycle());
+    next = std::min(next, theTagPipeline[i].nextReadyCycle());
+    next = std::min(next, theDataPipeline[i].nextReadyCycle());
+  }
+  return next;
+}
+
+void CacheController::accountSkippedCycles(uint64_t aCycles) {
+  // Nothing moved while idle, so each skipped cycle saw the current pipeline
+  // occupancy and only rotated the round-robin pointers
+  theMafUtilization << std::make_pair(totalPipelineSize(theMAFPipeline), aCycles);
+  theTagUtilization << std::make_pair(totalPipelineSize(theTagPipeline), aCycles);
+  theDataUtilization << std::make_pair(totalPipelineSize(theDataPipeline), aCycles);
+
+  int32_t core_shift = (theCores - aCycles % theCores) % theCores;
+  lastSnoopQueue = (lastSnoopQueue + core_shift) % theCores;
+  lastRequestQueue = (lastRequestQueue + core_shift) % theCores;
+  lastPrefetchQueue = (lastPrefetchQueue + core_shift) % theCores;
+
+  int32_t bank_shift = aCycles % theBanks;
+  theLastTagPipeline = (theLastTagPipeline + bank_shift) % theBanks;
+  theLastDataPipeline = (theLastDataPipeline + bank_shift) % theBanks;
+  theLastScheduledBank = (theLastScheduledBank + theBanks - bank_shift) % theBanks;
+}
+
 void CacheController::processMessages() {
   FLEXUS_PROFILE();
   DBG_(VVerb, (<< " Process messages"));
 
+  uint64_t now = theFlexus->cycleCount();
+  if (theLastProcessCycle > 0 && now > theLastProcessCycle + 1) {
+    accountSkippedCycles(now - theLastProcessCycle - 1);
+  }
+  theLastProcessCycle = now;
+
   {
     // Give a dummy variable to the backside in, which has one queue
     int32_t i = 0;
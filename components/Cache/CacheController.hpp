@@ -803,6 +803,9 @@ public:
   int64_t theTraceAddress;
   uint64_t theTraceTimeout;
 
+  // Cycle of the last processMessages() call, to account for skipped cycles
+  uint64_t theLastProcessCycle;
+
   // Now that there are an array of FrontSideOut ports
   // we need to look at each one to determine whether
   // the empty()/full() conditions are met globally.
@@ -899,7 +902,15 @@ public:
   // hits
   void processMessages();
 
+  // Earliest cycle at which processMessages() has work: now if anything is
+  // queued, otherwise when the first pipeline head completes.  Outstanding
+  // MAF entries only wait for replies, which arrive through the queues.
+  uint64_t nextEventCycle();
+
 private:
+  // Replays the per-cycle bookkeeping of cycles that were skipped while idle
+  void accountSkippedCycles(uint64_t aCycles);
+
   // Enqueue requests in the appropriate tag pipelines
   void enqueueTagPipeline(Action action, ProcessEntry_p aProcess);
 
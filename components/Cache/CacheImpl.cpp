@@ -107,6 +107,15 @@ public:
            (theController.get() ? theController->isQuiesced() : true);
   }
 
+  uint64_t nextEventCycle() const {
+    if (!theController.get() || theBusDirection != kIdle || theBackSideIn_ReplyBuffer ||
+        theBackSideIn_RequestBuffer || !theBackSideIn_ReplyInfiniteQueue.empty() ||
+        !theBackSideIn_RequestInfiniteQueue.empty()) {
+      return 0;
+    }
+    return theController->nextEventCycle();
+  }
+
   void saveState(std::string const &aDirName) {
     theController->saveState(aDirName);
   }
@@ -51,6 +51,7 @@
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <sstream>
 
 #include <boost/none.hpp>
 #include <boost/throw_exception.hpp>
@@ -393,6 +394,43 @@ public:
   }
 };
 
+// Both predictors store their tables as one flexpoint section per core, named
+// after the legacy binary file, so that BPWarm and FetchAddressGenerate
+// flexpoints are interchangeable.
+template <class Predictor>
+void saveFlexpointTables(Predictor const &aPredictor, Flexus::Core::FlexpointWriter &aWriter) {
+  std::ostringstream s(std::ios::out | std::ios::binary);
+  {
+    boost::archive::binary_oarchive oa(s);
+    oa << aPredictor.theBTB;
+    oa << aPredictor.theBimodal;
+    oa << aPredictor.theMeta;
+    oa << aPredictor.theGShare;
+  }
+  aWriter.addSection("bpred-" + boost::padded_string_cast<2, '0'>(aPredictor.theIndex), s.str());
+}
+
+template <class Predictor>
+bool loadFlexpointTables(Predictor &aPredictor, Flexus::Core::FlexpointReader const &aReader) {
+  Flexus::Core::FlexpointSection aSection;
+  if (!aReader.section("bpred-" + boost::padded_string_cast<2, '0'>(aPredictor.theIndex),
+                       aSection)) {
+    return false;
+  }
+  std::istringstream s(aSection.str(), std::ios::in | std::ios::binary);
+  boost::archive::binary_iarchive ia(s);
+  ia >> aPredictor.theBTB;
+  ia >> aPredictor.theBimodal;
+  ia >> aPredictor.theMeta;
+  ia >> aPredictor.theGShare;
+  DBG_(Dev, (<< aPredictor.theName << " loaded branch predictor.  BTB size: "
+             << aPredictor.theBTB.theBTBSets << " by " << aPredictor.theBTB.theBTBAssoc
+             << " Bimodal size: " << aPredictor.theBimodal.theSize
+             << " Meta size: " << aPredictor.theMeta.theSize
+             << " Gshare size: " << aPredictor.theGShare.theShiftRegSize));
+  return true;
+}
+
 struct CombiningImpl : public BranchPredictor {
 
   std::string theName;
@@ -809,6 +847,14 @@ struct CombiningImpl : public BranchPredictor {
       loadStateBinary(aDirName);
     }
   }
+
+  void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter) const {
+    saveFlexpointTables(*this, aWriter);
+  }
+
+  bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader) {
+    return loadFlexpointTables(*this, aReader);
+  }
 };
 
 struct FastCombiningImpl : public FastBranchPredictor {
@@ -1201,6 +1247,14 @@ struct FastCombiningImpl : public FastBranchPredictor {
       DBG_(Dev, (<< "Unable to load bpred state " << fname << ". Using default state."));
     }
   }
+
+  void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter) const {
+    saveFlexpointTables(*this, aWriter);
+  }
+
+  bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader) {
+    return loadFlexpointTables(*this, aReader);
+  }
 };
 
 BranchPredictor *BranchPredictor::combining(std::string const &aName, uint32_t anIndex) {
@@ -45,6 +45,7 @@
 #ifndef FLEXUS_FETCHADDRESSGENERATE_BRANCHPREDICTOR_HPP_INCLUDED
 #define FLEXUS_FETCHADDRESSGENERATE_BRANCHPREDICTOR_HPP_INCLUDED
 
+#include <core/flexpoint.hpp>
 #include <core/target.hpp>
 #include <core/types.hpp>
 #include <iostream>
@@ -63,6 +64,8 @@ struct BranchPredictor {
   }
   virtual void loadState(std::string const &aDirName) = 0;
   virtual void saveState(std::string const &aDirName) const = 0;
+  virtual void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter) const = 0;
+  virtual bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader) = 0;
 };
 
 struct FastBranchPredictor {
@@ -76,6 +79,8 @@ struct FastBranchPredictor {
   }
   virtual void loadState(std::string const &aDirName) = 0;
   virtual void saveState(std::string const &aDirName) const = 0;
+  virtual void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter) const = 0;
+  virtual bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader) = 0;
 };
 
 } // namespace SharedTypes
@@ -45,7 +45,8 @@
 #ifndef FLEXUS_COMMON_MESSAGE_QUEUES_HPP_INCLUDED
 #define FLEXUS_COMMON_MESSAGE_QUEUES_HPP_INCLUDED
 
-#include <list>
+#include <utility>
+#include <vector>
 
 #include <components/CommonQEMU/Transports/MemoryTransport.hpp>
 #include <core/stats.hpp>
@@ -60,8 +61,77 @@ using namespace Flexus;
 using namespace Core;
 using namespace SharedTypes;
 
+// Circular buffer backing the queues below.  Storage is preallocated from the
+// configured queue size; it only grows (by doubling) if a caller overruns the
+// nominal capacity, so steady-state enqueue/dequeue never touches the heap.
+template <class Element> class RingFifo {
+  std::vector<Element> theSlots;
+  uint32_t theHead;
+  uint32_t theCount;
+
+  uint32_t index(uint32_t anOffset) const {
+    uint32_t idx = theHead + anOffset;
+    return idx >= theSlots.size() ? idx - theSlots.size() : idx;
+  }
+
+  void grow(uint32_t aCapacity) {
+    std::vector<Element> slots(aCapacity);
+    for (uint32_t i = 0; i < theCount; ++i) {
+      slots[i] = std::move(theSlots[index(i)]);
+    }
+    theSlots.swap(slots);
+    theHead = 0;
+  }
+
+public:
+  RingFifo(uint32_t aCapacity = 1)
+      : theSlots(aCapacity > 0 ? aCapacity : 1), theHead(0), theCount(0) {
+  }
+
+  void reserve(uint32_t aCapacity) {
+    if (aCapacity > theSlots.size()) {
+      grow(aCapacity);
+    }
+  }
+
+  template <class T> void push_back(T &&anElement) {
+    if (theCount == theSlots.size()) {
+      grow(theSlots.size() * 2);
+    }
+    theSlots[index(theCount)] = std::forward<T>(anElement);
+    ++theCount;
+  }
+
+  Element &front() {
+    return theSlots[theHead];
+  }
+  Element const &front() const {
+    return theSlots[theHead];
+  }
+  Element &operator[](uint32_t anOffset) {
+    return theSlots[index(anOffset)];
+  }
+
+  // Moves the head element out and leaves a default-constructed slot behind so
+  // that references held by the element (e.g. intrusive_ptrs) are released.
+  Element pop_front() {
+    Element ret_val(std::move(theSlots[theHead]));
+    theSlots[theHead] = Element();
+    theHead = index(1);
+    --theCount;
+    return ret_val;
+  }
+
+  bool empty() const {
+    return theCount == 0;
+  }
+  uint32_t size() const {
+    return theCount;
+  }
+}; // class RingFifo
+
 template <class Transport> class MessageQueue {
-  std::list<std::pair<Transport, int64_t>> theQueue;
+  RingFifo<std::pair<Transport, int64_t>> theQueue;
   uint32_t theSize;
   uint32_t theCurrentUsage;
   uint32_t theCurrentReserve;
@@ -69,15 +139,27 @@ template <class Transport> class MessageQueue {
 public:
   MessageQueue() : theSize(1), theCurrentUsage(0), theCurrentReserve(0) {
   }
-  MessageQueue(uint32_t aSize) : theSize(aSize), theCurrentUsage(0), theCurrentReserve(0) {
+  MessageQueue(uint32_t aSize)
+      : theQueue(aSize), theSize(aSize), theCurrentUsage(0), theCurrentReserve(0) {
   }
 
   void setSize(uint32_t aSize) {
     theSize = aSize;
+    theQueue.reserve(aSize);
   }
 
   void enqueue(Transport const &aMessage) {
     theQueue.push_back(std::make_pair(aMessage, Flexus::Core::theFlexus->cycleCount()));
+    accountEnqueue(aMessage);
+  }
+
+  void enqueue(Transport &&aMessage) {
+    theQueue.push_back(std::make_pair(std::move(aMessage), Flexus::Core::theFlexus->cycleCount()));
+    accountEnqueue(theQueue[theQueue.size() - 1].first);
+  }
+
+private:
+  void accountEnqueue(Transport const &aMessage) {
     ++theCurrentUsage;
     ++theCurrentReserve;
     DBG_Assert(theCurrentReserve >= theCurrentUsage,
@@ -88,10 +170,10 @@ public:
                 << " when enqueuing " << *(aMessage[MemoryMessageTag])));
   }
 
+public:
   Transport dequeue() {
     DBG_Assert(!theQueue.empty());
-    Transport ret_val(theQueue.front().first);
-    theQueue.pop_front();
+    Transport ret_val(theQueue.pop_front().first);
     --theCurrentUsage;
     --theCurrentReserve;
     DBG_Assert(theCurrentReserve >= theCurrentUsage);
@@ -158,23 +240,24 @@ typedef uint64_t CycleTime;
 
 template <class Item> class DelayFifo {
   typedef std::pair<Item, CycleTime> DelayElement;
-  std::list<DelayElement> theQueue;
+  RingFifo<DelayElement> theQueue;
   uint32_t theSize;
   uint32_t theCurrentSize;
 
 public:
   DelayFifo() : theSize(1), theCurrentSize(0) {
   }
-  DelayFifo(uint32_t aSize) : theSize(aSize), theCurrentSize(0) {
+  DelayFifo(uint32_t aSize) : theQueue(aSize), theSize(aSize), theCurrentSize(0) {
   }
 
   void setSize(uint32_t aSize) {
     theSize = aSize;
+    theQueue.reserve(aSize);
   }
 
   void enqueue(Item anItem, uint32_t delay) {
     CycleTime ready = Flexus::Core::theFlexus->cycleCount() + delay;
-    theQueue.push_back(std::make_pair(anItem, ready));
+    theQueue.push_back(std::make_pair(std::move(anItem), ready));
     ++theCurrentSize;
   }
 
@@ -185,12 +268,18 @@ public:
     return (Flexus::Core::theFlexus->cycleCount() >= theQueue.front().second);
   }
 
+  // Cycle at which the head of the queue becomes ready, or UINT64_MAX if empty
+  CycleTime nextReadyCycle() const {
+    if (theCurrentSize == 0) {
+      return UINT64_MAX;
+    }
+    return theQueue.front().second;
+  }
+
   Item dequeue() {
-    // remove and remember the head of the queue
-    Item ret_val(theQueue.front().first);
-    theQueue.pop_front();
+    // remove and return the head of the queue
     --theCurrentSize;
-    return ret_val;
+    return std::move(theQueue.pop_front().first);
   }
 
   Item &peek() {
@@ -212,8 +301,8 @@ public:
 
 template <class Item> class PipelineFifo {
   typedef std::pair<Item, uint64_t> PipelineElement;
-  std::list<PipelineElement> theQueue;
-  std::list<uint64_t> theServerReadyTimes;
+  RingFifo<PipelineElement> theQueue;
+  RingFifo<uint64_t> theServerReadyTimes;
   uint32_t theCurrentSize;
   int64_t theIssueLatency;
   int64_t theLatency;
@@ -224,8 +313,8 @@ template <class Item> class PipelineFifo {
 public:
   PipelineFifo(std::string aName, uint32_t aNumPipelines, int64_t anIssueLatency, int64_t aLatency,
                boost::intrusive_ptr<Stat::StatLog2Histogram> anInterArrival = nullptr)
-      : theCurrentSize(0), theIssueLatency(anIssueLatency), theLatency(aLatency), theLastArrival(0),
-        theInterArrival(anInterArrival) {
+      : theServerReadyTimes(aNumPipelines), theCurrentSize(0), theIssueLatency(anIssueLatency),
+        theLatency(aLatency), theLastArrival(0), theInterArrival(anInterArrival) {
     DBG_Assert(aNumPipelines > 0);
     DBG_Assert(theIssueLatency >= 1);
     for (uint32_t i = 0; i < aNumPipelines; ++i) {
@@ -248,7 +337,7 @@ public:
       theServerReadyTimes.push_back(curr + theIssueLatency * (i + 1));
     }
     uint64_t complete = curr + theLatency * aRepeatCount;
-    theQueue.push_back(std::make_pair(anItem, complete));
+    theQueue.push_back(std::make_pair(std::move(anItem), complete));
     ++theCurrentSize;
     if (theInterArrival)
       *theInterArrival << (curr - theLastArrival);
@@ -262,13 +351,19 @@ public:
     return (Flexus::Core::theFlexus->cycleCount() >= theQueue.front().second);
   }
 
+  // Cycle at which the head of the pipeline completes, or UINT64_MAX if empty
+  CycleTime nextReadyCycle() const {
+    if (theCurrentSize == 0) {
+      return UINT64_MAX;
+    }
+    return theQueue.front().second;
+  }
+
   Item dequeue() {
     --theCurrentSize;
     DBG_Assert(theCurrentSize >= 0);
-    // remove and remember the head of the queue
-    Item ret_val(theQueue.front().first);
-    theQueue.pop_front();
-    return ret_val;
+    // remove and return the head of the queue
+    return std::move(theQueue.pop_front().first);
   }
 
   Item peek() {
@@ -276,11 +371,8 @@ public:
   }
 
   void stall() {
-    std::list<uint64_t>::iterator iter = theServerReadyTimes.begin();
-    std::list<uint64_t>::iterator end = theServerReadyTimes.end();
-    while (iter != end) {
-      ++(*iter);
-      ++iter;
+    for (uint32_t i = 0; i < theServerReadyTimes.size(); ++i) {
+      ++theServerReadyTimes[i];
     }
   }
   bool serverAvail() const {
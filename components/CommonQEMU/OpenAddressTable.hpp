@@ -0,0 +1,300 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#ifndef __COMMON_OPEN_ADDRESS_TABLE_HPP__
+#define __COMMON_OPEN_ADDRESS_TABLE_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#include <utility>
+#include <vector>
+
+#include <core/debug/debug.hpp>
+
+namespace nCommonUtil {
+
+// Hash table keyed by a 64-bit address, for structures such as infinite
+// directories that grow to millions of entries.
+//
+// Entries live in large, never-moving chunks, so an Entry * stays valid until
+// that key is erased.  The index is a Robin Hood open-addressing array of
+// 8-byte buckets (entry slot and 32 bits of hash), so a lookup touches one or
+// two bucket lines and then the entry itself.  Both the chunks and the index
+// may optionally be backed by transparent huge pages.
+template <typename _Value> class OpenAddressTable {
+public:
+  struct Entry {
+    uint64_t theKey;
+    _Value theValue;
+  };
+
+private:
+  // Free entries carry this key, so a stale Entry * can be detected
+  static const uint64_t kFreeKey = ~0ULL;
+  static const size_t kChunkBytes = 2 << 20;
+  static const size_t kChunkEntries =
+      kChunkBytes / sizeof(Entry) > 0 ? kChunkBytes / sizeof(Entry) : 1;
+
+  // theSlot is the entry index plus one; zero marks an empty bucket
+  struct Bucket {
+    uint32_t theSlot;
+    uint32_t theHash;
+  };
+
+  Bucket *theBuckets;
+  uint64_t theMask;
+  size_t theSize;
+  std::vector<Entry *> theChunks;
+  std::vector<uint32_t> theFreeSlots;
+  uint32_t theNextSlot;
+  bool theLargePages;
+
+  static uint32_t hash(uint64_t aKey) {
+    aKey ^= aKey >> 33;
+    aKey *= 0xff51afd7ed558ccdULL;
+    aKey ^= aKey >> 33;
+    aKey *= 0xc4ceb9fe1a85ec53ULL;
+    aKey ^= aKey >> 33;
+    return static_cast<uint32_t>(aKey);
+  }
+
+  size_t mappedSize(size_t aBytes) const {
+    size_t align = theLargePages ? (2 << 20) : 4096;
+    return (aBytes + align - 1) & ~(align - 1);
+  }
+
+  // Anonymous mappings come back zeroed, which is an empty index
+  void *map(size_t aBytes) {
+    void *p = mmap(nullptr, mappedSize(aBytes), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    DBG_Assert(p != MAP_FAILED, (<< "Unable to allocate " << aBytes << " bytes"));
+#ifdef MADV_HUGEPAGE
+    if (theLargePages) {
+      madvise(p, mappedSize(aBytes), MADV_HUGEPAGE);
+    }
+#endif
+    return p;
+  }
+
+  void unmap(void *p, size_t aBytes) {
+    if (p) {
+      munmap(p, mappedSize(aBytes));
+    }
+  }
+
+  size_t buckets() const {
+    return theBuckets ? theMask + 1 : 0;
+  }
+
+  Entry &entry(uint32_t aSlot) {
+    return theChunks[(aSlot - 1) / kChunkEntries][(aSlot - 1) % kChunkEntries];
+  }
+
+  uint32_t allocateSlot() {
+    if (!theFreeSlots.empty()) {
+      uint32_t slot = theFreeSlots.back();
+      theFreeSlots.pop_back();
+      return slot;
+    }
+    if ((theNextSlot - 1) / kChunkEntries == theChunks.size()) {
+      theChunks.push_back(static_cast<Entry *>(map(kChunkEntries * sizeof(Entry))));
+    }
+    return theNextSlot++;
+  }
+
+  // Place a bucket known not to be present, displacing richer buckets
+  void place(Bucket aBucket) {
+    uint64_t pos = aBucket.theHash & theMask;
+    uint64_t dist = 0;
+    while (theBuckets[pos].theSlot != 0) {
+      uint64_t other = (pos - (theBuckets[pos].theHash & theMask)) & theMask;
+      if (other < dist) {
+        std::swap(aBucket, theBuckets[pos]);
+        dist = other;
+      }
+      pos = (pos + 1) & theMask;
+      ++dist;
+    }
+    theBuckets[pos] = aBucket;
+  }
+
+  void grow() {
+    Bucket *old = theBuckets;
+    size_t old_count = buckets();
+    size_t count = old_count ? old_count * 2 : 1024;
+    theBuckets = static_cast<Bucket *>(map(count * sizeof(Bucket)));
+    theMask = count - 1;
+    for (size_t i = 0; i < old_count; ++i) {
+      if (old[i].theSlot != 0) {
+        place(old[i]);
+      }
+    }
+    unmap(old, old_count * sizeof(Bucket));
+  }
+
+  // Index of the bucket holding aKey, or -1
+  int64_t findBucket(uint64_t aKey) {
+    if (!theBuckets) {
+      return -1;
+    }
+    uint32_t h = hash(aKey);
+    uint64_t pos = h & theMask;
+    for (uint64_t dist = 0;; ++dist, pos = (pos + 1) & theMask) {
+      Bucket const &b = theBuckets[pos];
+      if (b.theSlot == 0 || ((pos - (b.theHash & theMask)) & theMask) < dist) {
+        return -1;
+      }
+      if (b.theHash == h && entry(b.theSlot).theKey == aKey) {
+        return pos;
+      }
+    }
+  }
+
+public:
+  OpenAddressTable()
+      : theBuckets(nullptr), theMask(0), theSize(0), theNextSlot(1), theLargePages(false) {
+  }
+
+  ~OpenAddressTable() {
+    for (size_t i = 0; i < buckets(); ++i) {
+      if (theBuckets[i].theSlot != 0) {
+        entry(theBuckets[i].theSlot).theValue.~_Value();
+      }
+    }
+    for (Entry *chunk : theChunks) {
+      unmap(chunk, kChunkEntries * sizeof(Entry));
+    }
+    unmap(theBuckets, buckets() * sizeof(Bucket));
+  }
+
+  OpenAddressTable(OpenAddressTable const &) = delete;
+  OpenAddressTable &operator=(OpenAddressTable const &) = delete;
+
+  // Must be called before the first insert
+  void setLargePages(bool aLargePages) {
+    DBG_Assert(theChunks.empty() && !theBuckets);
+    theLargePages = aLargePages;
+  }
+
+  size_t size() const {
+    return theSize;
+  }
+
+  // Bytes of index and entry storage currently mapped
+  size_t memoryUsage() const {
+    return mappedSize(buckets() * sizeof(Bucket)) +
+           theChunks.size() * mappedSize(kChunkEntries * sizeof(Entry));
+  }
+
+  Entry *find(uint64_t aKey) {
+    int64_t pos = findBucket(aKey);
+    return pos < 0 ? nullptr : &entry(theBuckets[pos].theSlot);
+  }
+
+  // True if anEntry still holds aKey, i.e. it has not been erased since it
+  // was returned by find() or insert()
+  static bool holds(Entry const *anEntry, uint64_t aKey) {
+    return anEntry && anEntry->theKey == aKey;
+  }
+
+  // Returns the entry for aKey and whether it was newly inserted
+  std::pair<Entry *, bool> insert(uint64_t aKey, _Value const &aValue) {
+    DBG_Assert(aKey != kFreeKey);
+    Entry *existing = find(aKey);
+    if (existing) {
+      return std::make_pair(existing, false);
+    }
+    // Robin Hood probing stays short up to ~90% occupancy
+    if ((theSize + 1) * 8 > buckets() * 7) {
+      grow();
+    }
+    uint32_t slot = allocateSlot();
+    Entry &e = entry(slot);
+    e.theKey = aKey;
+    new (&e.theValue) _Value(aValue);
+    place(Bucket{slot, hash(aKey)});
+    ++theSize;
+    return std::make_pair(&e, true);
+  }
+
+  bool erase(uint64_t aKey) {
+    int64_t found = findBucket(aKey);
+    if (found < 0) {
+      return false;
+    }
+    uint64_t pos = found;
+    uint32_t slot = theBuckets[pos].theSlot;
+    Entry &e = entry(slot);
+    e.theValue.~_Value();
+    e.theKey = kFreeKey;
+    theFreeSlots.push_back(slot);
+
+    // Backward-shift deletion, so no tombstones are needed
+    uint64_t next = (pos + 1) & theMask;
+    while (theBuckets[next].theSlot != 0 &&
+           ((next - (theBuckets[next].theHash & theMask)) & theMask) != 0) {
+      theBuckets[pos] = theBuckets[next];
+      pos = next;
+      next = (next + 1) & theMask;
+    }
+    theBuckets[pos].theSlot = 0;
+    --theSize;
+    return true;
+  }
+
+  template <typename _Fn> void forEach(_Fn aFn) {
+    for (size_t i = 0; i < buckets(); ++i) {
+      if (theBuckets[i].theSlot != 0) {
+        Entry &e = entry(theBuckets[i].theSlot);
+        aFn(e.theKey, e.theValue);
+      }
+    }
+  }
+};
+
+}; // namespace nCommonUtil
+
+#endif // ! __COMMON_OPEN_ADDRESS_TABLE_HPP__
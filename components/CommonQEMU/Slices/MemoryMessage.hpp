@@ -51,6 +51,7 @@
 #define FLEXUS_MemoryMessage_TYPE_PROVIDED
 
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/pool_alloc.hpp>
 
 #include <core/exception.hpp>
 #include <core/types.hpp>
@@ -71,7 +72,7 @@ uint32_t memoryMessageSerial(void);
 
 #define HEADER_SIZE 8
 
-struct MemoryMessage : public boost::counted_base { /*, public FastAlloc*/
+struct MemoryMessage : public boost::counted_base, public PoolAllocated<MemoryMessage> {
   typedef PhysicalMemoryAddress MemoryAddress;
 
   // enumerated message type
@@ -51,11 +51,13 @@
 #define FLEXUS_NetworkMessage_TYPE_PROVIDED
 
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/pool_alloc.hpp>
 
 namespace Flexus {
 namespace SharedTypes {
 
-struct NetworkMessage : public boost::counted_base {
+struct NetworkMessage : public boost::counted_base,
+                        public Flexus::Core::PoolAllocated<NetworkMessage> {
   int32_t src;  // source node
   int32_t dest; // destination node
   int32_t vc;   // virtual channel
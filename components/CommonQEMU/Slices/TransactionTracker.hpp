@@ -57,6 +57,7 @@
 #include <tuple>
 
 #include <core/boost_extensions/intrusive_ptr.hpp>
+#include <core/pool_alloc.hpp>
 #include <core/flexus.hpp>
 #include <core/types.hpp>
 
@@ -95,7 +96,7 @@ struct TransactionStatManager {
 
 uint64_t getTTGUID();
 
-class TransactionTracker : public boost::counted_base { /*, public FastAlloc*/
+class TransactionTracker : public boost::counted_base, public PoolAllocated<TransactionTracker> {
   typedef Flexus::SharedTypes::PhysicalMemoryAddress MemoryAddress;
 
   static std::shared_ptr<TransactionTracer> theTracer;
@@ -47,13 +47,18 @@
 #include <components/CommonQEMU/Slices/AbstractInstruction.hpp>
 #include <core/boost_extensions/intrusive_ptr.hpp>
 #include <core/debug/debug.hpp>
+#include <core/pool_alloc.hpp>
 
 namespace Flexus {
 namespace SharedTypes {
 
-static uint64_t translationID;
+// Shared by every translation unit that creates Translations
+inline uint64_t nextTranslationID() {
+  static uint64_t theNextID = 0;
+  return theNextID++;
+}
 
-struct Translation : public boost::counted_base {
+struct Translation : public boost::counted_base, public Flexus::Core::PoolAllocated<Translation> {
 
   enum eTranslationType { eStore, eLoad, eFetch };
 
@@ -63,7 +68,7 @@ struct Translation : public boost::counted_base {
 
   Translation()
       : theTLBstatus(kTLBunresolved), theTLBtype(kNONE), theReady(false), theWaiting(false),
-        theDone(false), theCurrentTranslationLevel(0), rawTTEValue(0), theID(translationID++),
+        theDone(false), theCurrentTranslationLevel(0), rawTTEValue(0), theID(nextTranslationID()),
         theAnnul(false), theTimeoutCounter(0), thePageFault(false), inTraceMode(false)
 
   {
@@ -551,6 +551,13 @@ struct TimeBreakdown {
     return aNumCycles;
   }
 
+  // Charge every cycle since the last accounted one as an idle stall in
+  // aTimeClass, for cycles the core was not modelled at all
+  int32_t idle(int32_t aTimeClass) {
+    theLastTimeClass = aTimeClass;
+    return stall(kIdle_Stall);
+  }
+
   int32_t retire(eCycleClass aPrecedingStallClass, uint64_t anInsnSequence, int32_t aTimeClass,
                  bool isSpin) {
     bool count_retire_cycle = false;
@@ -86,7 +86,7 @@ public:
 
   inline void makeExclusive(int32_t index) {
     DBG_Assert(theSharers.isSharer(index),
-               (<< "Core " << index << " is not a sharer " << theSharers.getSharers()));
+               (<< "Core " << index << " is not a sharer " << theSharers));
     DBG_Assert(theSharers.countSharers() == 1,
                (<< "Cannot make xclusive, sharers = " << theSharers));
     theState = OneSharer;
@@ -188,26 +188,23 @@ public:
   }
 
   void invalidateBlock(PhysicalMemoryAddress address, SharingVector sharers) {
-    std::list<int> slist(sharers.toList());
-
     MemoryMessage msg(MemoryMessage::Invalidate, address);
-    while (!slist.empty()) {
-      DBG_(Iface, Addr(address) Comp(*this)(<< "Sending Invalidate to core " << slist.front()
+    for (int32_t sharer : sharers) {
+      DBG_(Iface, Addr(address) Comp(*this)(<< "Sending Invalidate to core " << sharer
                                             << " for block " << std::hex << address));
       msg.type() = MemoryMessage::Invalidate;
 
       if (cfg.SeparateID) {
-        int32_t core = slist.front() >> 1;
-        if (slist.front() & 1) {
+        int32_t core = sharer >> 1;
+        if (sharer & 1) {
           FLEXUS_CHANNEL_ARRAY(SnoopOutI, core) << msg;
         } else {
           FLEXUS_CHANNEL_ARRAY(SnoopOutD, core) << msg;
         }
       } else {
-        FLEXUS_CHANNEL_ARRAY(SnoopOutI, slist.front()) << msg;
-        FLEXUS_CHANNEL_ARRAY(SnoopOutD, slist.front()) << msg;
+        FLEXUS_CHANNEL_ARRAY(SnoopOutI, sharer) << msg;
+        FLEXUS_CHANNEL_ARRAY(SnoopOutD, sharer) << msg;
       }
-      slist.pop_front();
     }
   }
 
@@ -270,9 +267,6 @@ public:
       DBG_(Crit, (<< "CMP width is NOT a power of 2, some stats will be invalid!"));
     }
 
-    DBG_Assert(theCMPWidth <= MAX_NUM_SHARERS,
-               (<< "This implementation only supports up to " << MAX_NUM_SHARERS << " nodes"));
-
     theDirStats = new DirectoryStats(statName());
     theCacheStats = new CacheStats(statName());
 
@@ -285,6 +279,7 @@ public:
     if (cfg.SeparateID) {
       theNumCaches *= 2;
     }
+    SharingVector::setWidth(theNumCaches);
 
     theDirectory = CREATE_DIRECTORY(cfg.DirectoryType);
     theDirectory->setNumCores(theCMPWidth);
@@ -444,9 +439,8 @@ public:
     }
 
     MemoryMessage snoop_msg(aMessage);
-    std::list<int> snoop_list = sharers.toList();
-    std::list<int>::iterator index_iter = snoop_list.begin();
-    for (; index_iter != snoop_list.end(); index_iter++) {
+    SharingVector::const_iterator index_iter = sharers.begin();
+    for (; index_iter != sharers.end(); index_iter++) {
       int32_t snoop_core = *index_iter;
       if (cfg.SeparateID) {
         snoop_core = (*index_iter) >> 1;
@@ -586,28 +580,28 @@ private:
       // provides others Since the Directory has a pointer to the Topology, We
       // provide flexibility by always letting the directory order the snoops
 
-      std::list<int> snoop_list = sharers.toList();
+      int32_t sharer_count = sharers.countSharers();
 
-      bool multiple_snoops = snoop_list.size() > 1;
+      bool multiple_snoops = sharer_count > 1;
 
-      potential_sharers = snoop_list.size();
+      potential_sharers = sharer_count;
       // Send snoops to all the nodes in the list we just made
       // We also track the messages we send, and use responses to update the
       // directory information If we receive the terminating condition, then
       // stop snooping
-      std::list<int>::iterator index_iter = snoop_list.begin();
-      for (; index_iter != snoop_list.end(); index_iter++) {
+      SharingVector::const_iterator index_iter = sharers.begin();
+      for (; index_iter != sharers.end(); index_iter++) {
         DBG_(Iface,
              Comp(*this) Addr(aMessage.address())(<< "Snoop list contains " << (*index_iter)));
-        if (snoop_list.size() == 2 && ((uint32_t)*index_iter == anIndex)) {
+        if (sharer_count == 2 && ((uint32_t)*index_iter == anIndex)) {
           multiple_snoops = false;
         }
       }
-      index_iter = snoop_list.begin();
+      index_iter = sharers.begin();
 
       bool found_terminal = false;
 
-      for (; index_iter != snoop_list.end(); index_iter++) {
+      for (; index_iter != sharers.end(); index_iter++) {
         // Skip the requesting node
         if ((uint32_t)*index_iter == anIndex) {
           DBG_(Iface,
@@ -50,7 +50,7 @@
 #include <components/FastCMPCache/AbstractDirectory.hpp>
 #include <components/FastCMPCache/AbstractProtocol.hpp>
 #include <components/FastCMPCache/SharingVector.hpp>
-#include <unordered_map>
+#include <core/fast_alloc.hpp>
 
 #include <algorithm>
 #include <list>
@@ -59,24 +59,27 @@
 // using nCommonSerializers::StdDirEntrySerializer;
 using nCommonSerializers::StdDirEntryExtendedSerializer;
 
+#include <components/CommonQEMU/OpenAddressTable.hpp>
 #include <components/CommonQEMU/Util.hpp>
 using nCommonUtil::log_base2;
+using nCommonUtil::OpenAddressTable;
 
 namespace nFastCMPCache {
 
-class InfiniteDirectoryEntry : public AbstractDirectoryEntry {
-  InfiniteDirectoryEntry(InfiniteDirectoryEntry &entry)
-      : address(entry.address), sharers(entry.sharers), state(entry.state) {
-  }
-  InfiniteDirectoryEntry(PhysicalMemoryAddress addr) : address(addr), state(ZeroSharers) {
+// Sharers and sharing state of one block, stored inline in the directory
+struct InfiniteDirectoryState {
+  SharingVector sharers;
+  SharingState state;
+
+  InfiniteDirectoryState() : state(ZeroSharers) {
   }
 
-  // InfiniteDirectoryEntry(const StdDirEntrySerializer & serializer) :
-  // address(serializer.tag) {
-  InfiniteDirectoryEntry(const StdDirEntryExtendedSerializer &serializer)
-      : address(serializer.tag) {
+  InfiniteDirectoryState(const StdDirEntryExtendedSerializer &serializer) {
     sharers.setSharers(serializer.state);
+    updateState();
+  }
 
+  void updateState() {
     int32_t count = sharers.countSharers();
     if (count == 1) {
       state = OneSharer;
@@ -86,108 +89,71 @@ class InfiniteDirectoryEntry : public AbstractDirectoryEntry {
       state = ManySharers;
     }
   }
+};
 
-  InfiniteDirectoryEntry() : address(0), state(ZeroSharers) {
+typedef OpenAddressTable<InfiniteDirectoryState> inf_directory_t;
+
+// Handle returned by lookup() so that later updates need not search the
+// directory again.  It refers to the table entry, which stays in place until
+// the block is erased; after that the directory falls back to a search.
+class InfiniteDirectoryEntry : public AbstractDirectoryEntry, public FastAlloc {
+  InfiniteDirectoryEntry(PhysicalMemoryAddress addr, inf_directory_t::Entry *entry)
+      : address(addr), entry(entry) {
   }
 
-private:
   PhysicalMemoryAddress address;
-  SharingVector sharers;
-  SharingState state;
+  inf_directory_t::Entry *entry;
 
   friend class InfiniteDirectory;
-  friend class HasZeroSharers;
-
-  inline void addSharer(int32_t index) {
-    sharers.addSharer(index);
-    if (sharers.countSharers() == 1) {
-      state = OneSharer;
-    } else {
-      state = ManySharers;
-    }
-  }
-
-  inline void makeExclusive(int32_t index) {
-    DBG_Assert(sharers.isSharer(index),
-               (<< "Core " << index << " is not a sharer " << sharers.getSharers() << " for block "
-                << std::hex << address));
-    DBG_Assert(sharers.countSharers() == 1);
-    state = OneSharer;
-  }
+};
 
-  inline void removeSharer(int32_t index) {
-    sharers.removeSharer(index);
-    if (sharers.countSharers() == 0) {
-      state = ZeroSharers;
-    } else if (sharers.countSharers() == 1) {
-      state = OneSharer;
-    }
-  }
+typedef boost::intrusive_ptr<InfiniteDirectoryEntry> InfiniteDirectoryEntry_p;
 
-  // StdDirEntrySerializer getSerializer() const {
-  //  return StdDirEntrySerializer((uint64_t)address, sharers.getUInt64());
-  //}
+class InfiniteDirectory : public AbstractDirectory {
+private:
+  inf_directory_t theDirectory;
+  Flexus::Stat::StatMax *theMemoryUsage;
 
-  StdDirEntryExtendedSerializer getSerializer() const {
-    return StdDirEntryExtendedSerializer((uint64_t)address, sharers.getSharers());
-  }
+  InfiniteDirectory() : AbstractDirectory(), theMemoryUsage(nullptr){};
 
-  // InfiniteDirectoryEntry & operator=(const StdDirEntrySerializer &
-  // serializer) {
-  InfiniteDirectoryEntry &operator=(const StdDirEntryExtendedSerializer &serializer) {
-    address = PhysicalMemoryAddress(serializer.tag);
-    sharers.setSharers(serializer.state);
-    int32_t count = sharers.countSharers();
-    if (count == 1) {
-      state = OneSharer;
-    } else if (count == 0) {
-      state = ZeroSharers;
-    } else {
-      state = ManySharers;
+  // The block's state, or nullptr if it is not tracked
+  InfiniteDirectoryState *findState(AbstractEntry_p dir_entry, PhysicalMemoryAddress address) {
+    InfiniteDirectoryEntry *my_entry = dynamic_cast<InfiniteDirectoryEntry *>(dir_entry.get());
+    if (my_entry != nullptr && inf_directory_t::holds(my_entry->entry, address)) {
+      return &my_entry->entry->theValue;
     }
-    return *this;
+    inf_directory_t::Entry *entry = theDirectory.find(address);
+    return entry ? &entry->theValue : nullptr;
   }
-};
-
-typedef boost::intrusive_ptr<InfiniteDirectoryEntry> InfiniteDirectoryEntry_p;
 
-struct HasZeroSharers {
-  bool
-  operator()(const std::pair<const PhysicalMemoryAddress, InfiniteDirectoryEntry_p> &entry) const {
-    return (entry.second->state == ZeroSharers);
+  InfiniteDirectoryState *findOrCreateState(AbstractEntry_p dir_entry,
+                                            PhysicalMemoryAddress address) {
+    InfiniteDirectoryState *my_state = findState(dir_entry, address);
+    if (my_state == nullptr) {
+      my_state = &theDirectory.insert(address, InfiniteDirectoryState()).first->theValue;
+      recordMemoryUsage();
+    }
+    return my_state;
   }
-};
 
-class InfiniteDirectory : public AbstractDirectory {
-private:
-  struct AddrHash {
-    std::size_t operator()(const PhysicalMemoryAddress &addr) const {
-      return addr >> 6;
+  void recordMemoryUsage() {
+    if (theMemoryUsage) {
+      *theMemoryUsage << theDirectory.memoryUsage();
     }
-  };
-  typedef std::unordered_map<PhysicalMemoryAddress, InfiniteDirectoryEntry_p, AddrHash>
-      inf_directory_t;
-  inf_directory_t theDirectory;
-
-  InfiniteDirectory() : AbstractDirectory(){};
+  }
 
 protected:
   virtual void addSharer(int32_t index, AbstractEntry_p dir_entry, PhysicalMemoryAddress address) {
-    InfiniteDirectoryEntry *my_entry = dynamic_cast<InfiniteDirectoryEntry *>(dir_entry.get());
-    if (my_entry == nullptr) {
-      my_entry = findOrCreateEntry(address);
-    }
-    my_entry->addSharer(index);
+    InfiniteDirectoryState *my_state = findOrCreateState(dir_entry, address);
+    my_state->sharers.addSharer(index);
+    my_state->updateState();
   }
 
   virtual void addExclusiveSharer(int32_t index, AbstractEntry_p dir_entry,
                                   PhysicalMemoryAddress address) {
-    InfiniteDirectoryEntry *my_entry = dynamic_cast<InfiniteDirectoryEntry *>(dir_entry.get());
-    if (my_entry == nullptr) {
-      my_entry = findOrCreateEntry(address);
-    }
-    my_entry->addSharer(index);
-    my_entry->makeExclusive(index);
+    InfiniteDirectoryState *my_state = findOrCreateState(dir_entry, address);
+    my_state->sharers.addSharer(index);
+    makeExclusive(index, *my_state, address);
   }
 
   virtual void failedSnoop(int32_t index, AbstractEntry_p dir_entry,
@@ -198,39 +164,45 @@ protected:
 
   virtual void removeSharer(int32_t index, AbstractEntry_p dir_entry,
                             PhysicalMemoryAddress address) {
-    InfiniteDirectoryEntry *my_entry = dynamic_cast<InfiniteDirectoryEntry *>(dir_entry.get());
-    if (my_entry == nullptr) {
+    if (dir_entry == nullptr) {
       return;
     }
-    my_entry->removeSharer(index);
+    InfiniteDirectoryState *my_state = findState(dir_entry, address);
+    if (my_state == nullptr) {
+      return;
+    }
+    my_state->sharers.removeSharer(index);
+    my_state->updateState();
   }
 
   virtual void makeSharerExclusive(int32_t index, AbstractEntry_p dir_entry,
                                    PhysicalMemoryAddress address) {
-    InfiniteDirectoryEntry *my_entry = dynamic_cast<InfiniteDirectoryEntry *>(dir_entry.get());
-    if (my_entry == nullptr) {
+    if (dir_entry == nullptr) {
+      return;
+    }
+    InfiniteDirectoryState *my_state = findState(dir_entry, address);
+    if (my_state == nullptr) {
       return;
     }
     // Make it exclusive
-    my_entry->makeExclusive(index);
+    makeExclusive(index, *my_state, address);
   }
 
-  InfiniteDirectoryEntry *findOrCreateEntry(PhysicalMemoryAddress addr) {
-    inf_directory_t::iterator iter;
-    bool success;
-    std::tie(iter, success) = theDirectory.insert(std::make_pair(addr, InfiniteDirectoryEntry_p()));
-    if (success) {
-      iter->second = new InfiniteDirectoryEntry(addr);
-    }
-    return iter->second.get();
+  void makeExclusive(int32_t index, InfiniteDirectoryState &my_state,
+                     PhysicalMemoryAddress address) {
+    DBG_Assert(my_state.sharers.isSharer(index),
+               (<< "Core " << index << " is not a sharer " << my_state.sharers
+                << " for block " << std::hex << address));
+    DBG_Assert(my_state.sharers.countSharers() == 1);
+    my_state.state = OneSharer;
   }
 
   InfiniteDirectoryEntry_p findEntry(PhysicalMemoryAddress addr) {
-    inf_directory_t::iterator iter = theDirectory.find(addr);
-    if (iter == theDirectory.end()) {
+    inf_directory_t::Entry *entry = theDirectory.find(addr);
+    if (entry == nullptr) {
       return nullptr;
     }
-    return iter->second;
+    return new InfiniteDirectoryEntry(addr, entry);
   }
 
 public:
@@ -242,8 +214,8 @@ public:
     SharingVector sharers;
     SharingState state = ZeroSharers;
     if (entry != nullptr) {
-      sharers = entry->sharers;
-      state = entry->state;
+      sharers = entry->entry->theValue.sharers;
+      state = entry->entry->theValue.state;
     }
 
     return std::tie(sharers, state, entry);
@@ -258,8 +230,8 @@ public:
     SharingState state = ZeroSharers;
     if (entry != nullptr) {
       valid = true;
-      sharers = entry->sharers;
-      state = entry->state;
+      sharers = entry->entry->theValue.sharers;
+      state = entry->entry->theValue.state;
     }
 
     return std::tie(sharers, state, entry, valid);
@@ -276,11 +248,11 @@ public:
       return;
     }
 
-    InfiniteDirectoryEntry *my_entry = dynamic_cast<InfiniteDirectoryEntry *>(dir_entry.get());
-    if (my_entry == nullptr) {
+    if (dir_entry == nullptr) {
       return;
     }
-    if (my_entry->state == ZeroSharers) {
+    InfiniteDirectoryState *my_state = findState(dir_entry, address);
+    if (my_state != nullptr && my_state->state == ZeroSharers) {
       theDirectory.erase(address);
     }
   }
@@ -293,12 +265,11 @@ public:
     DBG_(Dev, (<< "Saving " << count << " directory entries."));
     // StdDirEntrySerializer serializer;
     // StdDirEntryExtendedSerializer serializer;
-    inf_directory_t::iterator iter = theDirectory.begin();
-    for (; iter != theDirectory.end(); iter++) {
-      StdDirEntryExtendedSerializer const serializer = iter->second->getSerializer();
+    theDirectory.forEach([&oa](uint64_t address, InfiniteDirectoryState &my_state) {
+      StdDirEntryExtendedSerializer const serializer(address, my_state.sharers.getSharers());
       DBG_(Trace, (<< "Directory saving block: " << serializer));
       oa << serializer;
-    }
+    });
   }
 
   bool loadState(std::istream &s, const std::string &aDirName) {
@@ -311,15 +282,20 @@ public:
     for (; count > 0; count--) {
       ia >> serializer;
       DBG_(Trace, (<< "Directory loading block " << serializer));
-      InfiniteDirectoryEntry entry(serializer);
-      if (entry.state != ZeroSharers) {
-        theDirectory.insert(std::pair<PhysicalMemoryAddress, InfiniteDirectoryEntry *>(
-            PhysicalMemoryAddress(serializer.tag), new InfiniteDirectoryEntry(serializer)));
+      InfiniteDirectoryState my_state(serializer);
+      if (my_state.state != ZeroSharers) {
+        theDirectory.insert(serializer.tag, my_state);
       }
     }
+    recordMemoryUsage();
     return true;
   }
 
+  virtual void initialize(const std::string &aName) {
+    AbstractDirectory::initialize(aName);
+    theMemoryUsage = new Flexus::Stat::StatMax(aName + "-InfDir:MemoryBytes");
+  }
+
   static AbstractDirectory *createInstance(std::list<std::pair<std::string, std::string>> &args) {
     InfiniteDirectory *directory = new InfiniteDirectory();
 
@@ -327,7 +303,9 @@ public:
 
     std::list<std::pair<std::string, std::string>>::iterator iter = args.begin();
     for (; iter != args.end(); iter++) {
-      // Parse any specifc options we want
+      if (strcasecmp(iter->first.c_str(), "large_pages") == 0) {
+        directory->theDirectory.setLargePages(boost::lexical_cast<bool>(iter->second));
+      }
     }
 
     return directory;
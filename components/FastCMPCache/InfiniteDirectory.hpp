@@ -42,61 +42,45 @@
 // LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //  DO-NOT-REMOVE end-copyright-block
+
 #ifndef __INFINITE_DIRECTORY_HPP__
 #define __INFINITE_DIRECTORY_HPP__
 
 #include <boost/archive/binary_iarchive.hpp>
 
-#include <boost/multi_index/composite_key.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index_container.hpp>
-using namespace boost::multi_index;
-
+#include <components/CommonQEMU/OpenAddressTable.hpp>
 #include <components/CommonQEMU/Serializers.hpp>
 #include <components/CommonQEMU/Util.hpp>
+#include <core/stats.hpp>
 using nCommonSerializers::StdDirEntryExtendedSerializer;
-using nCommonUtil::AddressHash;
 using nCommonUtil::log_base2;
+using nCommonUtil::OpenAddressTable;
 
 namespace nCMPCache {
 
 template <typename _State, typename _EState = _State>
 class InfiniteDirectory : public AbstractDirectory<_State, _EState> {
 private:
+  // The address is the table key; the state is stored inline in the table
   struct InfDirEntry {
-    MemoryAddress theAddress;
-    mutable _State theState;
-    mutable bool theProtectedState;
-
-    InfDirEntry(MemoryAddress anAddress, _State aState)
-        : theAddress(anAddress), theState(aState), theProtectedState(false) {
-    }
+    _State theState;
+    bool theProtectedState;
 
-    InfDirEntry(const StdDirEntryExtendedSerializer &serializer, int32_t aNumSharers)
-        : theAddress(serializer.tag), theState(aNumSharers), theProtectedState(false) {
-      theState = serializer.state;
+    InfDirEntry(_State aState) : theState(aState), theProtectedState(false) {
     }
   };
 
-  typedef multi_index_container<
-      InfDirEntry,
-      indexed_by<hashed_unique<member<InfDirEntry, MemoryAddress, &InfDirEntry::theAddress>,
-                               AddressHash // From Common/Util.hpp
-                               >>>
-      inf_dir_t;
+  typedef OpenAddressTable<InfDirEntry> inf_dir_t;
+  typedef typename inf_dir_t::Entry entry_t;
 
   inf_dir_t theDirectory;
 
-  typedef typename inf_dir_t::iterator iterator;
-
   class InfiniteLookupResult : public AbstractLookupResult<_State> {
   private:
-    iterator theIterator;
+    entry_t *theEntry;
     bool isValid;
 
-    InfiniteLookupResult(iterator iter, bool valid) : theIterator(iter), isValid(valid) {
+    InfiniteLookupResult(entry_t *entry, bool valid) : theEntry(entry), isValid(valid) {
     }
 
     friend class InfiniteDirectory<_State, _EState>;
@@ -106,25 +90,25 @@ private:
       return isValid;
     }
     virtual bool isProtected() {
-      return theIterator->theProtectedState;
+      return theEntry->theValue.theProtectedState;
     }
     virtual void setProtected(bool val) {
-      theIterator->theProtectedState = val;
+      theEntry->theValue.theProtectedState = val;
     }
     virtual const _State &state() const {
-      return theIterator->theState;
+      return theEntry->theValue.theState;
     }
     virtual void addSharer(int32_t sharer) {
-      theIterator->theState.addSharer(sharer);
+      theEntry->theValue.theState.addSharer(sharer);
     }
     virtual void removeSharer(int32_t sharer) {
-      theIterator->theState.removeSharer(sharer);
+      theEntry->theValue.theState.removeSharer(sharer);
     }
     virtual void setSharer(int32_t sharer) {
-      theIterator->theState.setSharer(sharer);
+      theEntry->theValue.theState.setSharer(sharer);
     }
     virtual void setState(const _State &state) {
-      theIterator->theState = state;
+      theEntry->theValue.theState = state;
     }
   };
 
@@ -185,6 +169,12 @@ private:
 
   std::string theName;
 
+  Flexus::Stat::StatMax theMemoryUsage;
+
+  void recordMemoryUsage() {
+    theMemoryUsage << theDirectory.memoryUsage();
+  }
+
   int32_t getBank(uint64_t addr) {
     if (theSkewShift >= 0) {
       return ((addr >> theBankShift) ^ (addr >> theSkewShift)) & theBankMask;
@@ -207,7 +197,7 @@ public:
   InfiniteDirectory(const CMPCacheInfo &theInfo,
                     std::list<std::pair<std::string, std::string>> &args)
       : theEvictBuffer(theInfo.theDirEBSize), theSameSetReturnValue(false),
-        theName(theInfo.theName) {
+        theName(theInfo.theName), theMemoryUsage(theInfo.theName + "-InfDir:MemoryBytes") {
     theNumSharers = theInfo.theCores;
     theBlockSize = theInfo.theBlockSize;
     theBanks = theInfo.theNumBanks;
@@ -231,6 +221,8 @@ public:
     for (; iter != args.end(); iter++) {
       if (strcasecmp(iter->first.c_str(), "skew_shift") == 0) {
         theSkewShift = boost::lexical_cast<int>(iter->second);
+      } else if (strcasecmp(iter->first.c_str(), "large_pages") == 0) {
+        theDirectory.setLargePages(boost::lexical_cast<bool>(iter->second));
       } else {
         DBG_Assert(false, (<< "Unrecognized parameter '" << iter->first
                            << "' passed to InfiniteDirectory."));
@@ -243,13 +235,16 @@ public:
     InfiniteLookupResult *inf_lookup = dynamic_cast<InfiniteLookupResult *>(lookup.get());
     DBG_Assert(inf_lookup != nullptr,
                (<< "allocate() was not passed a valid InfiniteLookupResult"));
-    std::pair<iterator, bool> ret = theDirectory.insert(InfDirEntry(address, state));
-    inf_lookup->theIterator = ret.first;
+    std::pair<entry_t *, bool> ret = theDirectory.insert(address, InfDirEntry(state));
+    inf_lookup->theEntry = ret.first;
+    if (ret.second) {
+      recordMemoryUsage();
+    }
     return ret.second;
   }
   virtual boost::intrusive_ptr<AbstractLookupResult<_State>> lookup(MemoryAddress address) {
-    iterator iter = theDirectory.find(address);
-    return LookupResult_p(new LookupResult(iter, (iter != theDirectory.end())));
+    entry_t *entry = theDirectory.find(address);
+    return LookupResult_p(new LookupResult(entry, (entry != nullptr)));
   }
 
   virtual void remove(MemoryAddress address) {
@@ -289,9 +284,12 @@ public:
       if ((getBank(serializer.tag) == theLocalBankIndex) &&
           (getGroup(serializer.tag) == theGroupIndex)) {
         DBG_(Trace, (<< theName << " - Directory loading block " << serializer));
-        theDirectory.insert(InfDirEntry(serializer, theNumSharers));
+        _State state(theNumSharers);
+        state = serializer.state;
+        theDirectory.insert(serializer.tag, InfDirEntry(state));
       }
     }
+    recordMemoryUsage();
     return true;
   }
 };
@@ -46,163 +46,386 @@
 #define __FASTCMPCACHE_SHARINGVECTOR_HPP__
 
 #include <bitset>
-#include <list>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <utility>
 
 namespace nFastCMPCache {
 
+// Width of the sharer bit vectors stored in checkpoints
 #define MAX_NUM_SHARERS 512
 
+// Set of caches sharing a block, sized at runtime by setWidth().
+//
+// Up to 64 caches the set is a bit vector held inline.  Wider sets hold up to
+// kPointers sharers inline as a sorted list of 16-bit ids (limited pointers),
+// and spill to a heap-allocated bit vector only when more caches share the
+// block.  The set is always exact.  Iterate with begin()/end(), which visit
+// sharers in increasing order.
 class SharingVector {
-protected:
-  std::bitset<MAX_NUM_SHARERS> sharers;
+  static const int32_t kPointers = 4;
+  static const int32_t kPointerBits = 16;
+  static const int32_t kMaxWidth = (1 << kPointerBits) - 1;
+
+  // Inline bit vector, or kPointers fields of (sharer + 1), sorted and
+  // filled from the low end, with 0 marking an unused field
+  uint64_t theBits;
+  // words() words, once there are more than kPointers sharers
+  uint64_t *theOverflow;
+
+  static int32_t &width() {
+    static int32_t theWidth = MAX_NUM_SHARERS;
+    return theWidth;
+  }
+  static int32_t words() {
+    return (width() + 63) / 64;
+  }
+  static bool inlineMap() {
+    return width() <= 64;
+  }
+
+  int32_t pointer(int32_t i) const {
+    return static_cast<int32_t>((theBits >> (i * kPointerBits)) & kMaxWidth) - 1;
+  }
+  int32_t pointerCount() const {
+    int32_t n = 0;
+    while (n < kPointers && pointer(n) >= 0) {
+      n++;
+    }
+    return n;
+  }
+  void setPointers(const int32_t *sharers, int32_t n) {
+    theBits = 0;
+    for (int32_t i = 0; i < n; i++) {
+      theBits |= static_cast<uint64_t>(sharers[i] + 1) << (i * kPointerBits);
+    }
+  }
+
+  void spill() {
+    theOverflow = new uint64_t[words()]();
+    for (int32_t i = 0; i < kPointers && pointer(i) >= 0; i++) {
+      theOverflow[pointer(i) >> 6] |= 1ULL << (pointer(i) & 63);
+    }
+    theBits = 0;
+  }
 
-  SharingVector(const std::bitset<MAX_NUM_SHARERS> &s) : sharers(s) {
+  void copyFrom(const SharingVector &a) {
+    theBits = a.theBits;
+    theOverflow = nullptr;
+    if (a.theOverflow) {
+      theOverflow = new uint64_t[words()];
+      std::memcpy(theOverflow, a.theOverflow, words() * sizeof(uint64_t));
+    }
+  }
+
+  void checkIndex(int32_t index) const {
+    DBG_Assert((index >= 0) && (index < width()), (<< "Invalid index " << index));
   }
 
 public:
-  virtual ~SharingVector() {
+  // Number of caches tracked.  Must be set before any sharers are recorded.
+  static void setWidth(int32_t aWidth) {
+    DBG_Assert(aWidth > 0 && aWidth <= kMaxWidth,
+               (<< "Sharing vectors support up to " << kMaxWidth << " caches"));
+    width() = aWidth;
+  }
+
+  SharingVector() : theBits(0), theOverflow(nullptr) {
+  }
+  SharingVector(const SharingVector &a) {
+    copyFrom(a);
+  }
+  SharingVector(SharingVector &&a) : theBits(a.theBits), theOverflow(a.theOverflow) {
+    a.theBits = 0;
+    a.theOverflow = nullptr;
+  }
+  ~SharingVector() {
+    delete[] theOverflow;
   }
 
-  SharingVector() {
-    sharers.reset();
+  SharingVector &operator=(const SharingVector &a) {
+    if (this != &a) {
+      delete[] theOverflow;
+      copyFrom(a);
+    }
+    return *this;
+  }
+  SharingVector &operator=(SharingVector &&a) {
+    std::swap(theBits, a.theBits);
+    std::swap(theOverflow, a.theOverflow);
+    return *this;
   }
 
-  virtual void addSharer(int32_t index) {
-    DBG_Assert((index >= 0) && (index < MAX_NUM_SHARERS), (<< "Invalid index " << index));
-    sharers[index] = true;
+  void addSharer(int32_t index) {
+    checkIndex(index);
+    if (inlineMap()) {
+      theBits |= 1ULL << index;
+    } else if (theOverflow) {
+      theOverflow[index >> 6] |= 1ULL << (index & 63);
+    } else {
+      int32_t sharers[kPointers + 1];
+      int32_t n = 0;
+      for (int32_t i = 0; i < kPointers && pointer(i) >= 0; i++) {
+        if (pointer(i) == index) {
+          return;
+        }
+        sharers[n++] = pointer(i);
+      }
+      if (n == kPointers) {
+        spill();
+        theOverflow[index >> 6] |= 1ULL << (index & 63);
+        return;
+      }
+      int32_t pos = n;
+      while (pos > 0 && sharers[pos - 1] > index) {
+        sharers[pos] = sharers[pos - 1];
+        pos--;
+      }
+      sharers[pos] = index;
+      setPointers(sharers, n + 1);
+    }
   }
 
-  virtual void removeSharer(int32_t index) {
-    DBG_Assert((index >= 0) && (index < MAX_NUM_SHARERS), (<< "Invalid index " << index));
-    sharers[index] = false;
+  void removeSharer(int32_t index) {
+    checkIndex(index);
+    if (inlineMap()) {
+      theBits &= ~(1ULL << index);
+    } else if (theOverflow) {
+      theOverflow[index >> 6] &= ~(1ULL << (index & 63));
+    } else {
+      int32_t sharers[kPointers];
+      int32_t n = 0;
+      for (int32_t i = 0; i < kPointers && pointer(i) >= 0; i++) {
+        if (pointer(i) != index) {
+          sharers[n++] = pointer(i);
+        }
+      }
+      setPointers(sharers, n);
+    }
   }
 
-  virtual int32_t countSharers() const {
-    return sharers.count();
+  int32_t countSharers() const {
+    if (theOverflow) {
+      int32_t count = 0;
+      for (int32_t i = 0; i < words(); i++) {
+        count += __builtin_popcountll(theOverflow[i]);
+      }
+      return count;
+    }
+    return inlineMap() ? __builtin_popcountll(theBits) : pointerCount();
   }
 
-  virtual bool isSharer(int32_t index) const {
-    DBG_Assert((index >= 0) && (index < MAX_NUM_SHARERS), (<< "Invalid index " << index));
-    return sharers[index];
+  bool isSharer(int32_t index) const {
+    checkIndex(index);
+    if (inlineMap()) {
+      return (theBits >> index) & 1;
+    } else if (theOverflow) {
+      return (theOverflow[index >> 6] >> (index & 63)) & 1;
+    }
+    for (int32_t i = 0; i < kPointers && pointer(i) >= 0; i++) {
+      if (pointer(i) == index) {
+        return true;
+      }
+    }
+    return false;
   }
 
-  virtual int32_t getFirstSharer() const {
-    for (int32_t i = 0; i < MAX_NUM_SHARERS; i++) {
-      if (sharers[i]) {
-        return i;
+  // Smallest sharer >= index, or -1
+  int32_t nextSharer(int32_t index) const {
+    if (index >= width()) {
+      return -1;
+    }
+    if (inlineMap()) {
+      uint64_t bits = theBits & (~0ULL << index);
+      return bits ? __builtin_ctzll(bits) : -1;
+    } else if (theOverflow) {
+      int32_t word = index >> 6;
+      uint64_t bits = theOverflow[word] & (~0ULL << (index & 63));
+      while (!bits) {
+        if (++word == words()) {
+          return -1;
+        }
+        bits = theOverflow[word];
+      }
+      return word * 64 + __builtin_ctzll(bits);
+    }
+    for (int32_t i = 0; i < kPointers && pointer(i) >= 0; i++) {
+      if (pointer(i) >= index) {
+        return pointer(i);
       }
     }
     return -1;
   }
 
-  int32_t getClosestSharer(int32_t index) const {
-    int32_t lhs = index + 1;
-    int32_t rhs = index - 1;
-    for (; lhs < MAX_NUM_SHARERS; lhs++) {
-      if (sharers[lhs])
-        break;
+  class const_iterator {
+    const SharingVector *theVector;
+    int32_t theSharer;
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef int32_t value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const int32_t *pointer;
+    typedef const int32_t &reference;
+
+    const_iterator(const SharingVector *aVector, int32_t aSharer)
+        : theVector(aVector), theSharer(aSharer) {
+    }
+    int32_t operator*() const {
+      return theSharer;
     }
-    for (; rhs >= 0; rhs--) {
-      if (sharers[rhs])
+    const_iterator &operator++() {
+      theSharer = theVector->nextSharer(theSharer + 1);
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator old(*this);
+      ++*this;
+      return old;
+    }
+    bool operator==(const const_iterator &a) const {
+      return theSharer == a.theSharer;
+    }
+    bool operator!=(const const_iterator &a) const {
+      return theSharer != a.theSharer;
+    }
+  };
+
+  const_iterator begin() const {
+    return const_iterator(this, nextSharer(0));
+  }
+  const_iterator end() const {
+    return const_iterator(this, -1);
+  }
+
+  int32_t getFirstSharer() const {
+    return nextSharer(0);
+  }
+
+  int32_t getClosestSharer(int32_t index) const {
+    int32_t lhs = nextSharer(index + 1);
+    int32_t rhs = -1;
+    for (int32_t sharer : *this) {
+      if (sharer >= index) {
         break;
+      }
+      rhs = sharer;
     }
     if (rhs >= 0) {
-      if (lhs < MAX_NUM_SHARERS) {
-        if ((index - rhs) < (lhs - index)) {
-          return rhs;
-        } else {
-          return lhs;
-        }
-      } else {
-        return rhs;
+      if (lhs >= 0 && (lhs - index) <= (index - rhs)) {
+        return lhs;
       }
-    } else if (lhs < MAX_NUM_SHARERS) {
+      return rhs;
+    } else if (lhs >= 0) {
       return lhs;
-    } else if (sharers[index]) {
+    } else if (index >= 0 && index < width() && isSharer(index)) {
       return index;
     }
     return -1;
   }
 
-  virtual std::list<int> toList() const {
-    std::list<int> l;
-    for (int32_t i = 0; i < MAX_NUM_SHARERS; i++) {
-      if (sharers[i]) {
-        l.push_back(i);
-      }
+  // Sharers as stored in checkpoints
+  std::bitset<MAX_NUM_SHARERS> getSharers() const {
+    std::bitset<MAX_NUM_SHARERS> sharers;
+    for (int32_t sharer : *this) {
+      DBG_Assert(sharer < MAX_NUM_SHARERS,
+                 (<< "Sharer " << sharer << " does not fit in a checkpoint sharing vector"));
+      sharers[sharer] = true;
     }
-    return l;
-  }
-
-  virtual const std::bitset<MAX_NUM_SHARERS> &getSharers() const {
     return sharers;
   }
 
-  virtual const bool operator==(const SharingVector &a) const {
-    return (sharers == a.sharers);
+  void setSharers(const std::bitset<MAX_NUM_SHARERS> &s) {
+    clear();
+    for (int32_t i = 0; i < MAX_NUM_SHARERS; i++) {
+      if (s[i]) {
+        addSharer(i);
+      }
+    }
   }
 
-  virtual const bool operator!=(const SharingVector &a) const {
-    return (sharers != a.sharers);
+  bool operator==(const SharingVector &a) const {
+    if (inlineMap()) {
+      return theBits == a.theBits;
+    }
+    const_iterator i = begin(), j = a.begin();
+    for (; i != end() && j != a.end(); ++i, ++j) {
+      if (*i != *j) {
+        return false;
+      }
+    }
+    return i == end() && j == a.end();
   }
 
-  virtual const SharingVector operator&(const SharingVector &a) const {
-    return SharingVector(sharers & a.sharers);
+  bool operator!=(const SharingVector &a) const {
+    return !(*this == a);
   }
 
-  virtual SharingVector &operator=(const SharingVector &a) {
-    sharers = a.sharers;
-    return *this;
+  SharingVector operator&(const SharingVector &a) const {
+    SharingVector ret(*this);
+    ret &= a;
+    return ret;
   }
 
-  virtual SharingVector &operator&=(const SharingVector &a) {
-    sharers &= a.sharers;
-    return *this;
+  SharingVector &operator&=(const SharingVector &a) {
+    if (inlineMap()) {
+      theBits &= a.theBits;
+      return *this;
+    }
+    SharingVector ret;
+    for (int32_t sharer : *this) {
+      if (a.isSharer(sharer)) {
+        ret.addSharer(sharer);
+      }
+    }
+    return *this = std::move(ret);
   }
 
-  virtual SharingVector &operator|=(const SharingVector &a) {
-    sharers |= a.sharers;
+  SharingVector &operator|=(const SharingVector &a) {
+    if (inlineMap()) {
+      theBits |= a.theBits;
+      return *this;
+    }
+    for (int32_t sharer : a) {
+      addSharer(sharer);
+    }
     return *this;
   }
 
-  virtual void clear() {
-    sharers.reset();
-  }
-
-  virtual void flip() {
-    sharers.flip();
+  void clear() {
+    delete[] theOverflow;
+    theOverflow = nullptr;
+    theBits = 0;
   }
 
-  virtual const bool any() const {
-    return sharers.any();
+  bool any() const {
+    return nextSharer(0) >= 0;
   }
 
-  virtual uint64_t getUInt64() const {
+  // Sharers 0-63 as a bit vector
+  uint64_t getUInt64() const {
+    if (inlineMap() || theOverflow) {
+      return theOverflow ? theOverflow[0] : theBits;
+    }
     uint64_t ret = 0;
-    for (int32_t i = 63; i >= 0; i--) {
-      ret = ret << 1;
-      ret |= (sharers[i] ? 1 : 0);
+    for (int32_t i = 0; i < kPointers && pointer(i) >= 0 && pointer(i) < 64; i++) {
+      ret |= 1ULL << pointer(i);
     }
     return ret;
   }
-
-  virtual void setSharers(std::bitset<MAX_NUM_SHARERS> s) {
-    for (int32_t i = 0; i < MAX_NUM_SHARERS; i++)
-      sharers[i] = s[i];
-  }
-
-  //  virtual void setSharers(uint64_t s) {
-  //#if MAX_NUM_SHARERS > 64
-  //#error "MAX_NUM_SHARERS must be less than or equal to 64, or you just
-  // re-write some functions #endif
-  //    for (int32_t i = 0; i < 64; i++, s >>= 1) {
-  //      sharers[i] = (s & 1);
-  //    }
-  //  }
 };
 
 inline std::ostream &operator<<(std::ostream &os, const SharingVector &sharers) {
-  os << sharers.getSharers();
+  os << "{";
+  const char *sep = "";
+  for (int32_t sharer : sharers) {
+    os << sep << sharer;
+    sep = ",";
+  }
+  os << "}";
   return os;
 }
 
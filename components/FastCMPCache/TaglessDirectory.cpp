@@ -953,11 +953,13 @@ public:
 
     if (theTrackCollisions) {
       // How many extra bits are set
-      std::bitset<MAX_NUM_SHARERS> extra_bits = block->theTaglessState.sharers().getSharers();
-      extra_bits &= ~(block->theTrueState->sharers().getSharers());
-      extra_bits[index] = false;
-
-      int32_t num_extra_bits = extra_bits.count();
+      const SharingVector &true_sharers = block->theTrueState->sharers();
+      int32_t num_extra_bits = 0;
+      for (int32_t sharer : block->theTaglessState.sharers()) {
+        if (sharer != index && !true_sharers.isSharer(sharer)) {
+          num_extra_bits++;
+        }
+      }
 
       bool on_chip = ((block->theTrueState->state() == ManySharers) ||
                       ((block->theTrueState->state() == OneSharer) &&
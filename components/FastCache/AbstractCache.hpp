@@ -54,9 +54,11 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
 #include <functional>
+#include <sstream>
 
 using namespace boost::multi_index;
 
+#include <core/flexpoint.hpp>
 #include <core/types.hpp>
 
 using Flexus::SharedTypes::PhysicalMemoryAddress;
@@ -121,6 +123,30 @@ public:
   virtual void saveState(std::ostream &s) = 0;
 
   virtual bool loadState(std::istream &s) = 0;
+
+  // Unified flexpoint sections, all named aName or aName.<suffix>.  By default
+  // the saveState() stream is stored as a single section; caches with a flat
+  // layout override these to store their arrays directly.
+  virtual void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter, std::string const &aName,
+                             bool aCompress) {
+    std::ostringstream s(std::ios::out | std::ios::binary);
+    saveState(s);
+    aWriter.addSection(aName, s.str(),
+                       aCompress ? Flexus::Core::kFlexpointZlib : Flexus::Core::kFlexpointRaw);
+  }
+
+  // Returns false if the flexpoint has no sections for this cache
+  virtual bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader,
+                             std::string const &aName) {
+    Flexus::Core::FlexpointSection aSection;
+    if (!aReader.section(aName, aSection)) {
+      return false;
+    }
+    std::istringstream s(aSection.str(), std::ios::in | std::ios::binary);
+    bool ok = loadState(s);
+    DBG_Assert(ok, (<< "Error loading flexpoint section " << aName));
+    return true;
+  }
 };
 
 } // namespace nFastCache
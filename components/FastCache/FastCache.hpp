@@ -70,6 +70,7 @@ COMPONENT_PARAMETERS(
   PARAMETER( ERBSize, int, "Evicted Region Buffer size", "erb_size", 8 )
 
   PARAMETER( StdArray, bool, "Use Standard Tag Array instead of RegionTracker", "std_array", false )
+  PARAMETER( FlatArray, bool, "Use flat (structure-of-arrays) Standard Tag Array instead of RegionTracker", "flat_array", false )
 
   PARAMETER( BlockScout, bool, "Use precise block sharing info", "block_scout", false )
 
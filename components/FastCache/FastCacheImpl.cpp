@@ -54,6 +54,7 @@
 
 #include <components/FastCache/AbstractCache.hpp>
 #include <components/FastCache/CacheStats.hpp>
+#include <components/FastCache/FlatCache.hpp>
 #include <components/FastCache/RTCache.hpp>
 #include <components/FastCache/StdCache.hpp>
 
@@ -170,6 +171,20 @@ public:
     }
   }
 
+  // Text flexpoints are kept as separate files for compatibility with the old
+  // FastCache component and external tools.
+  bool hasFlexpointSections() const {
+    return !cfg.TextFlexpoints;
+  }
+
+  void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter) {
+    theCache->saveFlexpoint(aWriter, statName(), cfg.GZipFlexpoints);
+  }
+
+  bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader) {
+    return theCache->loadFlexpoint(aReader, statName());
+  }
+
   void initialize(void) {
     static volatile bool widthPrintout = true;
 
@@ -206,7 +221,16 @@ public:
     // Calculate shifts and masks
     theBlockMask = ~(cfg.BlockSize - 1);
 
-    if (cfg.StdArray) {
+    if (cfg.FlatArray) {
+      theCache = new FlatCache(statName(), cfg.BlockSize, num_sets, cfg.Associativity,
+                               [this](uint64_t aTagset, CoherenceState_t aLineState) {
+                                 return this->evict(aTagset, aLineState);
+                               },
+                               [this](uint64_t addr, bool icache, bool dcache) {
+                                 return this->sendInvalidate(addr, icache, dcache);
+                               },
+                               theIndex, cfg.CacheLevel, cfg.TextFlexpoints);
+    } else if (cfg.StdArray) {
       theCache = new StdCache(statName(), cfg.BlockSize, num_sets, cfg.Associativity,
                               [this](uint64_t aTagset, CoherenceState_t aLineState) {
                                 return this->evict(aTagset, aLineState);
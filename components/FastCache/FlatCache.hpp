@@ -0,0 +1,620 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#ifndef FLEXUS_FASTCACHE_FLAT_CACHE_HPP_INCLUDED
+#define FLEXUS_FASTCACHE_FLAT_CACHE_HPP_INCLUDED
+
+#include <components/FastCache/AbstractCache.hpp>
+
+#include <algorithm>
+#include <components/CommonQEMU/Serializers.hpp>
+#include <components/CommonQEMU/Util.hpp>
+#include <core/fast_alloc.hpp>
+#include <vector>
+
+using nCommonSerializers::BlockSerializer;
+using nCommonUtil::log_base2;
+
+#include <core/types.hpp>
+
+using Flexus::SharedTypes::PhysicalMemoryAddress;
+
+namespace nFastCache {
+
+// Drop-in replacement for StdCache that keeps the tag array in flat,
+// structure-of-arrays form: one contiguous tag, state and age array for the
+// whole cache, so that a set's tags are scanned from one cache-friendly run.  The
+// replacement order (true LRU) and the flexpoint format are identical to
+// StdCache, so flexpoints can be exchanged between the two.
+class FlatCache : public AbstractCache {
+private:
+  // Never a valid tag, since tags have the block offset bits cleared
+  static const uint64_t kNoTag = ~0ULL;
+
+  class FlatLookupResult : public LookupResult, public FastAlloc {
+  public:
+    PhysicalMemoryAddress theAddress;
+    CoherenceState_t theState;
+    int32_t theSet;
+    int32_t theSlot;
+    FlatCache *theCache;
+
+    FlatLookupResult(PhysicalMemoryAddress addr, CoherenceState_t state, int32_t set,
+                     int32_t slot, FlatCache *cache)
+        : theAddress(addr), theState(state), theSet(set), theSlot(slot), theCache(cache) {
+    }
+
+    virtual ~FlatLookupResult() {
+    }
+
+    virtual void allocate(CoherenceState_t new_state) {
+      theCache->allocate(theAddress, new_state, *this);
+    }
+
+    virtual void changeState(CoherenceState_t new_state, bool make_MRU, bool make_LRU) {
+      theCache->updateState(*this, new_state, make_MRU, make_LRU);
+    }
+
+    virtual void updateLRU() {
+      theCache->make_block_mru(theSet, theSlot);
+    }
+
+    virtual CoherenceState_t getState() {
+      int32_t idx = theCache->index(theSet, theSlot);
+      if (theCache->theTags[idx] == theAddress) {
+        return theCache->theStates[idx];
+      } else {
+        return theState;
+      }
+    }
+
+    virtual PhysicalMemoryAddress address() {
+      return theAddress;
+    }
+  };
+
+  typedef boost::intrusive_ptr<FlatLookupResult> FlatLookupResult_p;
+
+  std::string theName;
+  int32_t theNumSets;
+  int32_t theAssoc;
+  int32_t theBlockSize;
+  int32_t theStride;
+
+  int32_t blockShift;
+  int32_t blockSetMask;
+  int64_t blockTagMask;
+
+  evict_function_t evict;
+  invalidate_function_t sendInvalidate;
+  int32_t theIndex;
+  Flexus::SharedTypes::tFillLevel theLevel;
+
+  // theNumSets * theStride entries each.  A set fills its slots in order, so
+  // slots [0, theFill[set]) are in use.  Ages order the used slots from LRU
+  // (smallest) to MRU (largest).
+  std::vector<uint64_t> theTags;
+  std::vector<CoherenceState_t> theStates;
+  std::vector<int64_t> theAges;
+  std::vector<uint16_t> theFill;
+  int64_t theMRUStamp;
+  int64_t theLRUStamp;
+
+  bool theTextFlexpoints;
+  bool theAllocateInProgress;
+  int64_t theAllocateAddr;
+
+  // Geometry and replacement stamps stored alongside the arrays in flexpoints
+  struct FlexpointMeta {
+    int64_t theNumSets;
+    int64_t theAssoc;
+    int64_t theStride;
+    int64_t theMRUStamp;
+    int64_t theLRUStamp;
+  };
+
+  int32_t get_set(uint64_t addr) {
+    return (addr >> blockShift) & blockSetMask;
+  }
+
+  uint64_t get_tag(uint64_t addr) {
+    return (addr & blockTagMask);
+  }
+
+  int32_t index(int32_t set, int32_t slot) const {
+    return set * theStride + slot;
+  }
+
+  // Returns the slot holding tag in set, or -1
+  int32_t find_tag(int32_t set, uint64_t tag) const {
+    const uint64_t *tags = &theTags[set * theStride];
+    for (int32_t i = 0; i < theStride; ++i) {
+      if (tags[i] == tag) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  int32_t lru_slot(int32_t set) const {
+    const int64_t *ages = &theAges[set * theStride];
+    int32_t lru = 0;
+    for (int32_t i = 1; i < theFill[set]; ++i) {
+      if (ages[i] < ages[lru]) {
+        lru = i;
+      }
+    }
+    return lru;
+  }
+
+  // Slots of set ordered from LRU to MRU
+  void order_slots(int32_t set, std::vector<int32_t> &slots) const {
+    slots.clear();
+    for (int32_t i = 0; i < theFill[set]; ++i) {
+      slots.push_back(i);
+    }
+    const int64_t *ages = &theAges[set * theStride];
+    std::sort(slots.begin(), slots.end(),
+              [ages](int32_t a, int32_t b) { return ages[a] < ages[b]; });
+  }
+
+  // Append a block at the MRU position, as StdCache does when loading
+  void push_back(int32_t set, uint64_t tag, CoherenceState_t state) {
+    if (theFill[set] >= theAssoc || find_tag(set, tag) >= 0) {
+      return;
+    }
+    int32_t idx = index(set, theFill[set]++);
+    theTags[idx] = tag;
+    theStates[idx] = state;
+    theAges[idx] = ++theMRUStamp;
+  }
+
+public:
+  FlatCache(const std::string &aName, int32_t aBlockSize, int32_t aNumSets,
+            int32_t anAssociativity, evict_function_t anEvict,
+            invalidate_function_t aSendInvalidate, int32_t anIndex,
+            Flexus::SharedTypes::tFillLevel aLevel, bool aTextFlexpoints) {
+    theName = aName;
+    theNumSets = aNumSets;
+    theAssoc = anAssociativity;
+    theBlockSize = aBlockSize;
+    theTextFlexpoints = aTextFlexpoints;
+
+    theAllocateInProgress = false;
+
+    evict = anEvict;
+    sendInvalidate = aSendInvalidate;
+
+    theIndex = anIndex;
+    theLevel = aLevel;
+
+    DBG_Assert(theAssoc > 0);
+    DBG_Assert(theAssoc <= 0xFFFF);
+    DBG_Assert(theNumSets > 0);
+    DBG_Assert(theBlockSize > 0);
+    DBG_Assert((theNumSets & (theNumSets - 1)) == 0);
+    DBG_Assert((theBlockSize & (theBlockSize - 1)) == 0);
+
+    blockShift = log_base2(theBlockSize);
+    blockTagMask = ~(aBlockSize - 1);
+    blockSetMask = (theNumSets - 1);
+
+    theStride = theAssoc;
+    theTags.assign(theNumSets * theStride, static_cast<uint64_t>(kNoTag));
+    theStates.assign(theNumSets * theStride, kInvalid);
+    theAges.assign(theNumSets * theStride, 0);
+    theFill.assign(theNumSets, 0);
+    theMRUStamp = 0;
+    theLRUStamp = 0;
+  }
+
+  virtual ~FlatCache() {
+  }
+
+  void allocate(PhysicalMemoryAddress addr, CoherenceState_t new_state, FlatLookupResult &lookup) {
+    uint64_t new_tag = get_tag(addr);
+
+    theAllocateInProgress = true;
+    theAllocateAddr = new_tag;
+
+    int32_t idx = index(lookup.theSet, lookup.theSlot);
+
+    if (theTags[idx] != new_tag) {
+      if (isValid(theStates[idx])) {
+        evict(theTags[idx], theStates[idx]);
+      }
+      DBG_(Verb, Addr(theTags[idx])(<< "Replacing block " << std::hex << theTags[idx] << " ("
+                                    << theStates[idx] << ") with " << new_tag << " ("
+                                    << new_state << ")" << std::dec));
+      theTags[idx] = new_tag;
+    }
+    theStates[idx] = new_state;
+    theAges[idx] = ++theMRUStamp;
+
+    theAllocateInProgress = false;
+  }
+
+  void make_block_mru(int32_t set, int32_t slot) {
+    theAges[index(set, slot)] = ++theMRUStamp;
+  }
+
+  void make_block_lru(int32_t set, int32_t slot) {
+    theAges[index(set, slot)] = --theLRUStamp;
+  }
+
+  void updateState(FlatLookupResult &lookup, CoherenceState_t new_state, bool make_MRU,
+                   bool make_LRU) {
+    int32_t idx = index(lookup.theSet, lookup.theSlot);
+    DBG_(Verb, Addr(theTags[idx])(<< "Changing state of block " << std::hex << theTags[idx]
+                                  << " from " << theStates[idx] << " to " << new_state
+                                  << std::dec));
+    theStates[idx] = new_state;
+
+    if (make_MRU) {
+      make_block_mru(lookup.theSet, lookup.theSlot);
+    } else if (make_LRU) {
+      make_block_lru(lookup.theSet, lookup.theSlot);
+    }
+  }
+
+  virtual LookupResult_p lookup(uint64_t tagset) {
+    uint64_t tag = get_tag(tagset);
+    int32_t set = get_set(tagset);
+
+    int32_t slot = find_tag(set, tag);
+    if (slot >= 0) {
+      return FlatLookupResult_p(new FlatLookupResult(PhysicalMemoryAddress(tag),
+                                                     theStates[index(set, slot)], set, slot, this));
+    }
+
+    // Miss: fill an unused slot at the LRU position, or victimize the LRU block
+    if (theFill[set] < theAssoc) {
+      slot = theFill[set]++;
+      int32_t idx = index(set, slot);
+      theTags[idx] = tag;
+      theStates[idx] = kInvalid;
+      theAges[idx] = --theLRUStamp;
+    } else {
+      slot = lru_slot(set);
+    }
+
+    return FlatLookupResult_p(
+        new FlatLookupResult(PhysicalMemoryAddress(tag), kInvalid, set, slot, this));
+  }
+
+  virtual void getSetTags(uint64_t address, std::list<PhysicalMemoryAddress> &tags) {
+    int32_t set_index = get_set(address);
+
+    // First, check if we're in the process of allocating a new block to this
+    // set (This happens if this was called as a result of evicting a block
+    // during the allocation process)
+    if (theAllocateInProgress) {
+      int32_t alloc_set = get_set(theAllocateAddr);
+      if (alloc_set == set_index) {
+        tags.push_back(PhysicalMemoryAddress(theAllocateAddr));
+      }
+    }
+
+    // Now check all the Valid blocks in the given set
+    for (int32_t slot = 0; slot < theFill[set_index]; ++slot) {
+      int32_t idx = index(set_index, slot);
+      if (isValid(theStates[idx])) {
+        tags.push_back(PhysicalMemoryAddress(theTags[idx]));
+      }
+    }
+  }
+
+  virtual void saveState(std::ostream &s) {
+    static const int32_t kSave_ValidBit = 1;
+    static const int32_t kSave_DirtyBit = 2;
+    static const int32_t kSave_ModifiableBit = 4;
+
+    std::vector<int32_t> slots;
+
+    if (theTextFlexpoints) {
+      int32_t shift = blockShift + log_base2(theNumSets);
+
+      for (int32_t set = 0; set < theNumSets; set++) {
+        order_slots(set, slots);
+        s << "{";
+        int32_t way = 0;
+        for (; way < (int32_t)slots.size(); way++) {
+          int32_t idx = index(set, slots[way]);
+          uint64_t tag = theTags[idx] >> shift;
+
+          int32_t save_state = 0;
+          switch (theStates[idx]) {
+          case kModified:
+            save_state = (kSave_ValidBit | kSave_DirtyBit | kSave_ModifiableBit);
+            break;
+          case kOwned:
+            save_state = (kSave_ValidBit | kSave_DirtyBit);
+            break;
+          case kExclusive:
+            save_state = (kSave_ValidBit | kSave_ModifiableBit);
+            break;
+          case kShared:
+            save_state = (kSave_ValidBit);
+            break;
+          case kInvalid:
+            save_state = 0;
+            break;
+          default:
+            DBG_Assert(false, (<< "Don't know how to save state " << theStates[idx]));
+            break;
+          }
+
+          DBG_(Trace, (<< theName << " - Saving block " << std::hex << theTags[idx]
+                       << " with state " << state2String(theStates[idx]) << " in way " << way));
+
+          s << "[ " << save_state << " " << static_cast<uint64_t>(tag) << " ]";
+        }
+        for (; way < theAssoc; way++) {
+          s << "[ 0 0 ]";
+        }
+        s << "} < ";
+        for (int32_t j = 0; j < theAssoc; j++) {
+          s << j << " ";
+        }
+        s << "> " << std::endl;
+      }
+    } else {
+      boost::archive::binary_oarchive oa(s);
+
+      uint64_t set_count = theNumSets;
+      uint32_t associativity = theAssoc;
+
+      oa << set_count;
+      oa << associativity;
+
+      BlockSerializer bs;
+      for (int32_t set = 0; set < theNumSets; set++) {
+        order_slots(set, slots);
+        int32_t way = 0;
+        for (; way < (int32_t)slots.size(); way++) {
+          int32_t idx = index(set, slots[way]);
+          bs.tag = theTags[idx];
+          bs.way = slots[way];
+          switch (theStates[idx]) {
+          case kModified:
+            bs.state = (uint8_t)'M';
+            break;
+          case kOwned:
+            bs.state = (uint8_t)'O';
+            break;
+          case kExclusive:
+            bs.state = (uint8_t)'E';
+            break;
+          case kShared:
+            bs.state = (uint8_t)'S';
+            break;
+          case kInvalid:
+            bs.state = (uint8_t)'I';
+            break;
+          default:
+            DBG_Assert(false, (<< "Don't know how to save state " << theStates[idx]));
+            break;
+          }
+          oa << bs;
+          DBG_(Trace, Addr(theTags[idx])(<< theName << ": saving block " << std::hex
+                                         << theTags[idx] << " in state " << (char)bs.state));
+        }
+        bs.state = 'I';
+        bs.tag = 0;
+        for (; way < theAssoc; way++) {
+          bs.way = way;
+          oa << bs;
+        }
+      }
+    }
+  }
+
+  virtual bool loadState(std::istream &s) {
+    static const int32_t kSave_ValidBit = 1;
+    static const int32_t kSave_DirtyBit = 2;
+    static const int32_t kSave_ModifiableBit = 4;
+
+    if (theTextFlexpoints) {
+      int32_t shift = blockShift + log_base2(theNumSets);
+
+      char paren;
+      int32_t dummy;
+      int32_t load_state;
+      uint64_t load_tag;
+      for (int32_t set = 0; set < theNumSets; set++) {
+        s >> paren; // {
+        if (paren != '{') {
+          DBG_(Crit, (<< "Expected '{' when loading checkpoint"));
+          return false;
+        }
+        for (int32_t j = 0; j < theAssoc; j++) {
+          s >> paren >> load_state >> load_tag >> paren;
+
+          CoherenceState_t state(kInvalid);
+          switch (load_state) {
+          case (kSave_ValidBit | kSave_DirtyBit | kSave_ModifiableBit):
+            state = kModified;
+            break;
+          case (kSave_ValidBit | kSave_DirtyBit):
+            state = kOwned;
+            break;
+          case (kSave_ValidBit | kSave_ModifiableBit):
+            state = kExclusive;
+            break;
+          case (kSave_ValidBit):
+            state = kShared;
+            break;
+          case 0:
+            state = kInvalid;
+            break;
+          default:
+            DBG_Assert(false, (<< "Don't know how to load state " << load_state));
+            break;
+          }
+
+          DBG_(Trace, (<< theName << " - Loading block " << std::hex
+                       << ((load_tag << shift) | (set << blockShift)) << " with state "
+                       << state2String(state) << " in way " << j));
+          push_back(set, ((load_tag << shift) | (set << blockShift)), state);
+        }
+        s >> paren; // }
+        if (paren != '}') {
+          DBG_(Crit, (<< "Expected '}' when loading checkpoint"));
+          return false;
+        }
+
+        // useless associativity information
+        s >> paren; // <
+        if (paren != '<') {
+          DBG_(Crit, (<< "Expected '<' when loading checkpoint"));
+          return false;
+        }
+        for (int32_t j = 0; j < theAssoc; j++) {
+          s >> dummy;
+        }
+        s >> paren; // >
+        if (paren != '>') {
+          DBG_(Crit, (<< "Expected '>' when loading checkpoint"));
+          return false;
+        }
+      }
+    } else {
+      boost::archive::binary_iarchive ia(s);
+
+      uint64_t set_count = 0;
+      uint32_t associativity = 0;
+
+      ia >> set_count;
+      ia >> associativity;
+
+      DBG_Assert(set_count == (uint64_t)theNumSets,
+                 (<< "Error loading cache state. Flexpoint contains " << set_count
+                  << " sets but simulator configured for " << theNumSets << " sets."));
+      DBG_Assert(associativity == (uint64_t)theAssoc,
+                 (<< "Error loading cache state. Flexpoint contains " << associativity
+                  << "-way sets but simulator configured for " << theAssoc << "-way sets."));
+
+      for (int32_t set = 0; set < theNumSets; set++) {
+        for (int32_t way = 0; way < theAssoc; way++) {
+          BlockSerializer bs;
+          ia >> bs;
+          CoherenceState_t bstate = kInvalid;
+          switch (bs.state) {
+          case (uint8_t)'M':
+            bstate = kModified;
+            break;
+          case (uint8_t)'O':
+            bstate = kOwned;
+            break;
+          case (uint8_t)'E':
+            bstate = kExclusive;
+            break;
+          case (uint8_t)'S':
+            bstate = kShared;
+            break;
+          case (uint8_t)'I':
+            bstate = kInvalid;
+            break;
+          default:
+            DBG_Assert(false, (<< "Unknown Block State: " << (uint8_t)bs.state));
+            break;
+          }
+          DBG_(Trace, (<< theName << " - Loading block " << std::hex << bs.tag << " in state "
+                       << (char)bs.state));
+          push_back(set, bs.tag, bstate);
+        }
+      }
+    }
+    return true;
+  }
+
+  // The arrays are stored as-is, so loading is a bulk copy per array rather
+  // than a per-block replay through push_back().
+  virtual void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter, std::string const &aName,
+                             bool aCompress) {
+    Flexus::Core::FlexpointCodec codec =
+        aCompress ? Flexus::Core::kFlexpointZlib : Flexus::Core::kFlexpointRaw;
+    FlexpointMeta meta = {theNumSets, theAssoc, theStride, theMRUStamp, theLRUStamp};
+    aWriter.addSection(aName + ".meta", &meta, sizeof(meta));
+    aWriter.addArray(aName + ".tags", theTags, codec);
+    aWriter.addArray(aName + ".states", theStates, codec);
+    aWriter.addArray(aName + ".ages", theAges, codec);
+    aWriter.addArray(aName + ".fill", theFill, codec);
+  }
+
+  virtual bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader,
+                             std::string const &aName) {
+    Flexus::Core::FlexpointSection section;
+    if (!aReader.section(aName + ".meta", section)) {
+      // Possibly saved by a cache with a different organization
+      return AbstractCache::loadFlexpoint(aReader, aName);
+    }
+    FlexpointMeta meta;
+    DBG_Assert(section.size() == sizeof(meta));
+    std::memcpy(&meta, section.data(), sizeof(meta));
+    DBG_Assert(meta.theNumSets == theNumSets && meta.theAssoc == theAssoc,
+               (<< "Error loading cache state. Flexpoint contains " << meta.theNumSets << " "
+                << meta.theAssoc << "-way sets but simulator configured for " << theNumSets
+                << " " << theAssoc << "-way sets."));
+    DBG_Assert(meta.theStride == theStride);
+    theMRUStamp = meta.theMRUStamp;
+    theLRUStamp = meta.theLRUStamp;
+
+    size_t entries = theTags.size();
+    bool ok = aReader.section(aName + ".tags", section) && section.copyTo(theTags) &&
+              theTags.size() == entries;
+    ok = ok && aReader.section(aName + ".states", section) && section.copyTo(theStates) &&
+         theStates.size() == entries;
+    ok = ok && aReader.section(aName + ".ages", section) && section.copyTo(theAges) &&
+         theAges.size() == entries;
+    ok = ok && aReader.section(aName + ".fill", section) && section.copyTo(theFill) &&
+         theFill.size() == (size_t)theNumSets;
+    DBG_Assert(ok, (<< "Error loading flexpoint sections " << aName << ".*"));
+    return true;
+  }
+};
+
+} // namespace nFastCache
+
+#endif /* FLEXUS_FASTCACHE_FLAT_CACHE_HPP_INCLUDED */
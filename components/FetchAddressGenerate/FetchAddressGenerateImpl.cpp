@@ -52,6 +52,7 @@
 #define DBG_SetDefaultOps AddCat(FetchAddressGenerate)
 #include DBG_Control()
 
+#include <core/dormancy.hpp>
 #include <core/flexus.hpp>
 #include <core/qemu/mai_api.hpp>
 
@@ -81,6 +82,9 @@ class FLEXUS_COMPONENT(FetchAddressGenerate) {
   std::unique_ptr<BranchPredictor> theBranchPredictor;
   uint32_t theCurrentThread;
 
+  // No fetch address was generated last cycle; set until a redirect arrives
+  bool theBlocked;
+
 public:
   FLEXUS_COMPONENT_CONSTRUCTOR(FetchAddressGenerate) : base(FLEXUS_PASS_CONSTRUCTOR_ARGS) {
   }
@@ -110,6 +114,7 @@ public:
       theRedirect[i] = false;
     }
     theCurrentThread = cfg.Threads;
+    theBlocked = false;
     theBranchPredictor.reset(BranchPredictor::combining(statName(), flexusIndex()));
   }
 
@@ -121,6 +126,16 @@ public:
     return true;
   }
 
+  uint64_t nextEventCycle() const {
+    // A blocked generator waits for FAQ space, which uFetch reports as its own
+    // work, or for a redirect
+    if (cfg.Threads == 1 &&
+        (theBlocked || Flexus::Core::CoreDormancy::dormancy().isDormant(flexusIndex()))) {
+      return UINT64_MAX;
+    }
+    return 0;
+  }
+
   void saveState(std::string const &aDirName) {
     theBranchPredictor->saveState(aDirName);
   }
@@ -129,6 +144,18 @@ public:
     theBranchPredictor->loadState(aDirName);
   }
 
+  bool hasFlexpointSections() const {
+    return true;
+  }
+
+  void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter) {
+    theBranchPredictor->saveFlexpoint(aWriter);
+  }
+
+  bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader) {
+    return theBranchPredictor->loadFlexpoint(aReader);
+  }
+
 public:
   // RedirectIn
   //----------
@@ -136,6 +163,7 @@ public:
 #if FLEXUS_TARGET_IS(ARM)
   FLEXUS_PORT_ARRAY_ALWAYS_AVAILABLE(RedirectIn);
   void push(interface::RedirectIn const &, index_t anIndex, MemoryAddress &aRedirect) {
+    theBlocked = false;
     theRedirectPC[anIndex] = aRedirect;
     theRedirect[anIndex] = true;
   }
@@ -143,6 +171,7 @@ public:
   FLEXUS_PORT_ARRAY_ALWAYS_AVAILABLE(RedirectIn);
   void push(interface::RedirectIn const &, index_t anIndex,
             std::pair<MemoryAddress, MemoryAddress> &aRedirect) {
+    theBlocked = false;
     theRedirectPC[anIndex] = aRedirect.first;
     theRedirectNextPC[anIndex] = aRedirect.second;
     theRedirect[anIndex] = true;
@@ -165,6 +194,8 @@ public:
     int32_t td = 0;
     if (cfg.Threads > 1) {
       td = nMTManager::MTManager::get()->scheduleFAGThread(flexusIndex());
+    } else if (Flexus::Core::CoreDormancy::dormancy().isDormant(flexusIndex())) {
+      return;
     }
     doAddressGen(td);
   }
@@ -256,6 +287,7 @@ private:
       //      test = 1;
     }
 
+    theBlocked = fetch->theFetches.empty();
     if (fetch->theFetches.size() > 0) {
       DBG_(VVerb, (<< "Sending total fetches: " << fetch->theFetches.size()));
 
@@ -61,6 +61,8 @@ COMPONENT_PARAMETERS(
     PARAMETER( Cores, int, "Number of cores", "cores", 1 )
     PARAMETER( iTLBSize, size_t, "Size of the Instruction TLB", "itlbsize", 64 )
     PARAMETER( dTLBSize, size_t, "Size of the Data TLB", "dtlbsize", 64 )
+    PARAMETER( iTLBAssoc, size_t, "Associativity of the Instruction TLB (0 = fully associative)", "itlbassoc", 0 )
+    PARAMETER( dTLBAssoc, size_t, "Associativity of the Data TLB (0 = fully associative)", "dtlbassoc", 0 )
     PARAMETER( PerfectTLB, bool, "TLB never misses", "perfecttlb", false )
 );
 
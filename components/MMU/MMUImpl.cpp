@@ -52,6 +52,7 @@
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <boost/serialization/unordered_map.hpp>
 
 #include <components/MMU/MMU.hpp>
@@ -63,6 +64,7 @@
 #include "pageWalk.hpp"
 #include <components/CommonQEMU/Translation.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -130,66 +132,141 @@ private:
     }
   };
 
+  // Set-associative TLB with true LRU replacement within each set.  An
+  // associativity of 0 makes the TLB fully associative.  Checkpoints keep the
+  // old format (a map of entries whose rate is the age since last use), so
+  // they load into any geometry.
   struct TLB {
 
     friend class boost::serialization::access;
 
-    template <class Archive> void serialize(Archive &ar, const unsigned int version) {
-      ar &theTLB;
+    template <class Archive> void save(Archive &ar, const unsigned int version) const {
+      std::unordered_map<VirtualMemoryAddress, TLBentry> tlb;
+      for (size_t i = 0; i < theWays.size(); ++i) {
+        if (theWays[i].theValid) {
+          TLBentry entry(theWays[i].theVaddr);
+          entry.thePaddr = theWays[i].thePaddr;
+          entry.theRate = theClock - theWays[i].theLastUse;
+          tlb.insert({entry.theVaddr, entry});
+        }
+      }
+      ar &tlb;
       ar &theSize;
     }
 
+    template <class Archive> void load(Archive &ar, const unsigned int version) {
+      std::unordered_map<VirtualMemoryAddress, TLBentry> tlb;
+      size_t size;
+      ar &tlb;
+      ar &size;
+
+      // Insert the oldest entries first so the LRU order survives
+      std::vector<TLBentry> entries;
+      for (auto &entry : tlb) {
+        entries.push_back(entry.second);
+      }
+      std::sort(entries.begin(), entries.end(), [](TLBentry const &a, TLBentry const &b) {
+        return a.theRate > b.theRate;
+      });
+      for (auto &entry : entries) {
+        insert(entry.theVaddr, entry.thePaddr);
+      }
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
     std::pair<bool, PhysicalMemoryAddress> lookUp(const VirtualMemoryAddress &anAddress) {
       std::pair<bool, PhysicalMemoryAddress> ret{false, PhysicalMemoryAddress(0)};
-      for (auto iter = theTLB.begin(); iter != theTLB.end(); ++iter) {
-        iter->second.theRate++;
-        if (iter->second.theVaddr == anAddress) {
-          iter->second.theRate = 0;
-          ret.first = true;
-          ret.second = iter->second.thePaddr;
-        }
+      ++theClock;
+      Way *way = find(anAddress);
+      if (way) {
+        way->theLastUse = theClock;
+        ret.first = true;
+        ret.second = way->thePaddr;
       }
       return ret;
     }
 
-    TLBentry &operator[](VirtualMemoryAddress anAddress) {
-      auto iter = theTLB.find(anAddress);
-      if (iter == theTLB.end()) {
-        size_t s = theTLB.size();
-        if (s == theSize) {
-          evict();
+    void insert(VirtualMemoryAddress anAddress, PhysicalMemoryAddress aPaddr) {
+      Way *way = find(anAddress);
+      if (!way) {
+        Way *set = &theWays[setIndex(anAddress) * theAssoc];
+        way = set;
+        for (size_t i = 0; i < theAssoc; ++i) {
+          if (!set[i].theValid) {
+            way = &set[i];
+            break;
+          }
+          if (set[i].theLastUse < way->theLastUse) {
+            way = &set[i];
+          }
         }
-        std::pair<tlbIterator, bool> result;
-        result = theTLB.insert({anAddress, TLBentry(anAddress)});
-        assert(result.second);
-        iter = result.first;
+        if (!way->theValid) {
+          ++theCount;
+        }
+        way->theValid = true;
+        way->theVaddr = anAddress;
+        way->theLastUse = ++theClock;
       }
-      return iter->second;
+      way->thePaddr = aPaddr;
     }
 
-    void resize(size_t aSize) {
-      theTLB.reserve(aSize);
+    void resize(size_t aSize, size_t anAssoc) {
+      DBG_Assert(aSize > 0);
+      if (anAssoc == 0 || anAssoc > aSize) {
+        anAssoc = aSize;
+      }
+      if (aSize % anAssoc != 0) {
+        DBG_(Crit, (<< "TLB size " << aSize << " is not a multiple of its associativity "
+                     << anAssoc << "; making it fully associative"));
+        anAssoc = aSize;
+      }
       theSize = aSize;
+      theAssoc = anAssoc;
+      theSets = aSize / anAssoc;
+      thePow2Sets = (theSets & (theSets - 1)) == 0;
+      theWays.assign(aSize, Way());
+      theCount = 0;
+      theClock = 0;
     }
 
     size_t size() {
-      return theTLB.size();
+      return theCount;
     }
 
   private:
-    void evict() {
-      auto res = theTLB.begin();
-      for (auto iter = theTLB.begin(); iter != theTLB.end(); ++iter) {
-        if (iter->second.theRate > res->second.theRate) {
-          res = iter;
+    struct Way {
+      bool theValid;
+      uint64_t theLastUse;
+      VirtualMemoryAddress theVaddr;
+      PhysicalMemoryAddress thePaddr;
+
+      Way() : theValid(false), theLastUse(0) {
+      }
+    };
+
+    size_t setIndex(VirtualMemoryAddress anAddress) const {
+      uint64_t page = uint64_t(anAddress) >> 12;
+      return thePow2Sets ? page & (theSets - 1) : page % theSets;
+    }
+
+    Way *find(VirtualMemoryAddress anAddress) {
+      Way *set = &theWays[setIndex(anAddress) * theAssoc];
+      for (size_t i = 0; i < theAssoc; ++i) {
+        if (set[i].theValid && set[i].theVaddr == anAddress) {
+          return &set[i];
         }
       }
-      theTLB.erase(res);
+      return nullptr;
     }
 
     size_t theSize;
-    std::unordered_map<VirtualMemoryAddress, TLBentry> theTLB;
-    typedef std::unordered_map<VirtualMemoryAddress, TLBentry>::iterator tlbIterator;
+    size_t theAssoc;
+    size_t theSets;
+    bool thePow2Sets;
+    size_t theCount;
+    uint64_t theClock;
+    std::vector<Way> theWays;
   };
 
   std::unique_ptr<PageWalk> thePageWalker;
@@ -214,6 +291,16 @@ public:
     return false;
   }
 
+  uint64_t nextEventCycle() const {
+    // Lookups are queued by push, so an MMU with no lookups or walks in
+    // flight has nothing to do until then
+    if (theLookUpEntries.empty() && thePageWalkEntries.empty() &&
+        (!thePageWalker || thePageWalker->isIdle())) {
+      return UINT64_MAX;
+    }
+    return 0;
+  }
+
   void saveState(std::string const &aDirName) {
     std::ofstream iFile, dFile;
     iFile.open(aDirName + "/iTLBout", std::ofstream::out | std::ofstream::app);
@@ -245,6 +332,41 @@ public:
     dFile.close();
   }
 
+  // Each core stores its TLBs as its own flexpoint sections, rather than
+  // appending to the shared iTLBout/dTLBout files
+  bool hasFlexpointSections() const {
+    return true;
+  }
+
+  void saveFlexpoint(Flexus::Core::FlexpointWriter &aWriter) {
+    std::ostringstream iStream(std::ios::out | std::ios::binary);
+    std::ostringstream dStream(std::ios::out | std::ios::binary);
+    {
+      boost::archive::binary_oarchive ioarch(iStream);
+      boost::archive::binary_oarchive doarch(dStream);
+      ioarch << theInstrTLB;
+      doarch << theDataTLB;
+    }
+    aWriter.addSection(statName() + ".iTLB", iStream.str());
+    aWriter.addSection(statName() + ".dTLB", dStream.str());
+  }
+
+  bool loadFlexpoint(Flexus::Core::FlexpointReader const &aReader) {
+    Flexus::Core::FlexpointSection iSection, dSection;
+    if (!aReader.section(statName() + ".iTLB", iSection) ||
+        !aReader.section(statName() + ".dTLB", dSection)) {
+      return false;
+    }
+    std::istringstream iStream(iSection.str(), std::ios::in | std::ios::binary);
+    std::istringstream dStream(dSection.str(), std::ios::in | std::ios::binary);
+    boost::archive::binary_iarchive iiarch(iStream);
+    boost::archive::binary_iarchive diarch(dStream);
+    iiarch >> theInstrTLB;
+    diarch >> theDataTLB;
+    DBG_(Dev, (<< "Entries - iTLB:" << theInstrTLB.size() << ", dTLB:" << theDataTLB.size()));
+    return true;
+  }
+
   // Initialization
   void initialize() {
     theCPU = std::make_shared<Flexus::Qemu::Processor>(
@@ -252,8 +374,8 @@ public:
     thePageWalker.reset(new PageWalk(flexusIndex()));
     thePageWalker->setMMU(theMMU);
     theMMUInitialized = false;
-    theInstrTLB.resize(cfg.iTLBSize);
-    theDataTLB.resize(cfg.dTLBSize);
+    theInstrTLB.resize(cfg.iTLBSize, cfg.iTLBAssoc);
+    theDataTLB.resize(cfg.dTLBSize, cfg.dTLBAssoc);
   }
 
   void finalize() {
@@ -362,9 +484,9 @@ public:
         DBG_Assert(item->isInstr() != item->isData());
         DBG_(Iface, (<< "Item is " << (item->isInstr() ? "Instruction" : "Data") << " entry "
                      << item->theVaddr));
-        (item->isInstr() ? theInstrTLB
-                         : theDataTLB)[(VirtualMemoryAddress)(item->theVaddr & PAGEMASK)] =
-            (PhysicalMemoryAddress)(item->thePaddr & PAGEMASK);
+        (item->isInstr() ? theInstrTLB : theDataTLB)
+            .insert((VirtualMemoryAddress)(item->theVaddr & PAGEMASK),
+                    (PhysicalMemoryAddress)(item->thePaddr & PAGEMASK));
         if (item->isInstr())
           FLEXUS_CHANNEL(iTranslationReply) << item;
         else
@@ -518,8 +640,8 @@ public:
       }
       thePageWalker->push_back_trace(aTranslate,
                                      Flexus::Qemu::Processor::getProcessor((int)flexusIndex()));
-      (aTranslate->isInstr() ? theInstrTLB : theDataTLB)[aTranslate->theVaddr] =
-          aTranslate->thePaddr;
+      (aTranslate->isInstr() ? theInstrTLB : theDataTLB)
+          .insert(aTranslate->theVaddr, aTranslate->thePaddr);
     }
   }
 };
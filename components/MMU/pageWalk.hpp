@@ -76,6 +76,9 @@ public:
                        Flexus::Qemu::Processor theCPU);
   TranslationPtr popMemoryRequest();
   bool hasMemoryRequest();
+  bool isIdle() const {
+    return theTranslationTransports.empty() && theMemoryTranslations.empty();
+  }
   void annulAll();
 
 private:
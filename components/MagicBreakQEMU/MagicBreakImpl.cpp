@@ -293,6 +293,10 @@ public:
     return true; // MagicBreakComponent is always quiesced
   }
 
+  uint64_t nextEventCycle() const {
+    return theCycleTracker ? theCycleTracker->nextTickCycle() : UINT64_MAX;
+  }
+
   void saveState(std::string const &aDirName) {
     std::string fname(aDirName);
     fname += "/" + statName();
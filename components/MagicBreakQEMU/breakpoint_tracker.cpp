@@ -539,6 +539,17 @@ public:
       Flexus::Core::theFlexus->terminateSimulation();
     }
   }
+
+  virtual uint64_t nextTickCycle() const {
+    uint64_t next = UINT64_MAX;
+    if (theCkptInterval > 0) {
+      next = theLastCkpt + theCkptInterval + 1;
+    }
+    if (theStopCycle > 0 && theStopCycle < next) {
+      next = theStopCycle;
+    }
+    return next;
+  }
 };
 
 #if FLEXUS_TARGET_IS(v9)
@@ -97,6 +97,8 @@ struct SimPrintHandler : public BreakpointTracker {
 
 struct CycleTracker : public BreakpointTracker {
   virtual void tick() = 0;
+  // First cycle at which tick() has something to do
+  virtual uint64_t nextTickCycle() const = 0;
   virtual ~CycleTracker(){};
 };
 
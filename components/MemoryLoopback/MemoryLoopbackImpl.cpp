@@ -87,6 +87,14 @@ public:
     return outQueue->empty();
   }
 
+  uint64_t nextEventCycle() const {
+    if (!outQueue) {
+      return 0;
+    }
+    // Only the reply queue generates work; requests arrive via push
+    return outQueue->nextReadyCycle();
+  }
+
   // Initialization
   void initialize() {
     if (cfg.Delay < 1) {
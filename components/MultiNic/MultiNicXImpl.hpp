@@ -107,6 +107,11 @@ public:
     return currRecvCount == 0 && currSendCount == 0;
   }
 
+  uint64_t nextEventCycle() const {
+    // The drive only moves queued messages; new ones arrive through push
+    return isQuiesced() ? UINT64_MAX : 0;
+  }
+
   // Initialization
   void initialize() {
     recvQueue.resize(cfg.VChannels);
@@ -52,7 +52,7 @@
 #include <components/CommonQEMU/Transports/MemoryTransport.hpp>
 
 COMPONENT_PARAMETERS(
-  FLEXUS_PARAMETER( NetworkTopologyFile, std::string, "Network topology file", "topology-file", "" )
+  FLEXUS_PARAMETER( NetworkTopologyFile, std::string, "Network topology file, or a generated topology such as 'Torus 8x8:1'", "topology-file", "" )
   FLEXUS_PARAMETER( NumNodes, int, "Number of Nodes", "nodes", 2)
   FLEXUS_PARAMETER( VChannels, int, "Number of virtual channels", "virtual-channels", 3)
 );
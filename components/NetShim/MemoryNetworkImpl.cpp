@@ -73,6 +73,9 @@ using namespace Core;
 using namespace SharedTypes;
 using namespace nNetShim;
 
+// Cycle at which the average packet latency is written to LatencyOut
+static const uint64_t kLatencyReportCycle = 149999;
+
 class FLEXUS_COMPONENT(MemoryNetwork) {
   FLEXUS_COMPONENT_IMPL(MemoryNetwork);
 
@@ -100,6 +103,17 @@ public:
     return transports.empty();
   }
 
+  uint64_t nextEventCycle() const {
+    if (!nc->isIdle()) {
+      return 0;
+    }
+    // The latency report is written at a fixed cycle
+    if (Flexus::Core::theFlexus->cycleCount() < kLatencyReportCycle) {
+      return kLatencyReportCycle;
+    }
+    return UINT64_MAX;
+  }
+
   // Initialization
   void initialize() {
     int i;
@@ -124,6 +138,7 @@ public:
     if (nc->buildNetwork(cfg.NetworkTopologyFile.c_str())) {
       throw Flexus::Core::FlexusException("Error building the network");
     }
+    theLastDriveCycle = Flexus::Core::theFlexus->cycleCount();
   }
 
   void finalize() {
@@ -153,8 +168,12 @@ public:
   // Drive Interfaces
   void drive(interface::NetworkDrive const &) {
     nNetShim::currTime = Flexus::Core::theFlexus->cycleCount();
+    if (static_cast<uint64_t>(nNetShim::currTime) > theLastDriveCycle + 1) {
+      nc->skipIdleCycles(nNetShim::currTime - theLastDriveCycle - 1);
+    }
+    theLastDriveCycle = nNetShim::currTime;
 
-    if (nNetShim::currTime == 149999) {
+    if (static_cast<uint64_t>(nNetShim::currTime) == kLatencyReportCycle) {
       double avg_latency = double(latency) / double(PacketCount);
       LatencyOut << "latency of netshim : " << avg_latency;
       LatencyOut.flush();
@@ -204,19 +223,24 @@ public:
   // message and deliver to the destination node. Encapsulated in a function
   // object "theDeliver" to call from outside code
   bool deliverMessage(const MessageState *msg) {
-    index_t pdest = (transports[msg->serial][NetworkMessageTag]->dest) * cfg.VChannels +
-                    transports[msg->serial][NetworkMessageTag]->vc;
+    // A copy: the receiver may inject new packets, which can grow the slab
+    // and move its entries.
+    MemoryTransport transport = transports[msg];
+
+    index_t pdest = (transport[NetworkMessageTag]->dest) * cfg.VChannels +
+                    transport[NetworkMessageTag]->vc;
 
-    int32_t vc = transports[msg->serial][NetworkMessageTag]->vc;
+    int32_t vc = transport[NetworkMessageTag]->vc;
+    bool isData = transport[NetworkMessageTag]->size > 8;
 
     DBG_(Trace, (<< "Network Delivering msg From " << msg->srcNode << " to " << msg->destNode
                  << ", on vc " << msg->networkVC << ", serial: " << msg->serial
-                 << " Message =  " << *(transports[msg->serial][MemoryMessageTag])));
+                 << " Message =  " << *(transport[MemoryMessageTag])));
 
-    FLEXUS_CHANNEL_ARRAY(ToNode, pdest) << transports[msg->serial];
+    FLEXUS_CHANNEL_ARRAY(ToNode, pdest) << transport;
 
     ++theTotalMessages;
-    if (transports[msg->serial][NetworkMessageTag]->size > 8) {
+    if (isData) {
       ++theTotalMessages_Data;
     } else {
       ++theTotalMessages_NoData;
@@ -226,7 +250,7 @@ public:
     // actual size
     theTotalFlits += msg->transmitLatency;
     theTotalFlitHops += (msg->hopCount * msg->transmitLatency);
-    if (transports[msg->serial][NetworkMessageTag]->size > 8) {
+    if (isData) {
       theDataFlitHops += msg->hopCount * msg->transmitLatency;
       // No consistent way to identify how many flits used for non-data portion
       // of data message so just put entire message in the data bin.
@@ -252,7 +276,7 @@ public:
         *theAcceptWaitTimes[vc] << std::make_pair ( msg->acceptTime, 1 );
     */
 
-    transports.erase(msg->serial);
+    transports.erase(msg);
 
     return false;
   }
@@ -324,9 +348,8 @@ private:
       transport[TransactionTrackerTag]->setDelayCause("Network", cause);
     }
 
-    // We index the actual transport object through a map of serial numbers
-    // (assigned when the MessageState object is allocated) to transports
-    transports.insert(make_pair(msg->serial, transport));
+    // We index the actual transport object by the slot of its MessageState
+    transports.insert(msg, transport);
 
     DBG_(Iface, (<< "New packet: "
                  << " serial=" << msg->serial << " src=" << transport[NetworkMessageTag]->src
@@ -344,8 +367,7 @@ private:
     }
   }
 
-  std::pair<int, MemoryTransport> SerialTrans;
-  std::map<const int, MemoryTransport> transports;
+  MessageSlab<MemoryTransport> transports;
 
   NetContainer *nc;
 
@@ -365,6 +387,9 @@ private:
   std::vector<boost::intrusive_ptr<Stat::StatLog2Histogram>> theAcceptWaitTimes;
 
   Stat::StatMax theMaxInfiniteBuffer;
+
+  // Cycle of the last drive, to account for cycles skipped while idle
+  uint64_t theLastDriveCycle;
 };
 
 } // End Namespace nNetwork
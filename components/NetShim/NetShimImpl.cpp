@@ -89,6 +89,13 @@ public:
     return transports.empty();
   }
 
+  uint64_t nextEventCycle() const {
+    if (!nc->isIdle()) {
+      return 0;
+    }
+    return UINT64_MAX;
+  }
+
   // Initialization
   void initialize() {
     int i;
@@ -107,6 +114,7 @@ public:
     if (nc->buildNetwork(cfg.NetworkTopologyFile.c_str())) {
       throw Flexus::Core::FlexusException("Error building the network");
     }
+    theLastDriveCycle = Flexus::Core::theFlexus->cycleCount();
   }
 
   void finalize() {
@@ -136,6 +144,10 @@ public:
   // Drive Interfaces
   void drive(interface::NetworkDrive const &) {
     nNetShim::currTime = Flexus::Core::theFlexus->cycleCount();
+    if (static_cast<uint64_t>(nNetShim::currTime) > theLastDriveCycle + 1) {
+      nc->skipIdleCycles(nNetShim::currTime - theLastDriveCycle - 1);
+    }
+    theLastDriveCycle = nNetShim::currTime;
 
     // We need to use function objects for calls back into simics from the
     // NetShim. In particular, checking if a node will accept a message
@@ -181,15 +193,20 @@ public:
   // message and deliver to the destination node. Encapsulated in a function
   // object "theDeliver" to call from outside code
   bool deliverMessage(const MessageState *msg) {
-    index_t pdest = (transports[msg->serial][NetworkMessageTag]->dest) * cfg.VChannels +
-                    transports[msg->serial][NetworkMessageTag]->vc;
+    // A copy: the receiver may inject new packets, which can grow the slab
+    // and move its entries.
+    NetworkTransport transport = transports[msg];
+
+    index_t pdest = (transport[NetworkMessageTag]->dest) * cfg.VChannels +
+                    transport[NetworkMessageTag]->vc;
 
-    int32_t vc = transports[msg->serial][NetworkMessageTag]->vc;
+    int32_t vc = transport[NetworkMessageTag]->vc;
+    bool isData = transport[NetworkMessageTag]->size;
 
-    FLEXUS_CHANNEL_ARRAY(ToNode, pdest) << transports[msg->serial];
+    FLEXUS_CHANNEL_ARRAY(ToNode, pdest) << transport;
 
     ++theTotalMessages;
-    if (transports[msg->serial][NetworkMessageTag]->size) {
+    if (isData) {
       ++theTotalMessages_Data;
     } else {
       ++theTotalMessages_NoData;
@@ -208,7 +225,7 @@ public:
         *theAcceptWaitTimes[vc] << std::make_pair ( msg->acceptTime, 1 );
     */
 
-    transports.erase(msg->serial);
+    transports.erase(msg);
 
     return false;
   }
@@ -272,9 +289,8 @@ private:
       transport[TransactionTrackerTag]->setDelayCause("Network", cause);
     }
 
-    // We index the actual transport object through a map of serial numbers
-    // (assigned when the MessageState object is allocated) to transports
-    transports.insert(make_pair(msg->serial, transport));
+    // We index the actual transport object by the slot of its MessageState
+    transports.insert(msg, transport);
 
     DBG_(Iface, (<< "New packet: "
                  << " serial=" << msg->serial << " src=" << transport[NetworkMessageTag]->src
@@ -288,8 +304,7 @@ private:
     }
   }
 
-  std::pair<int, NetworkTransport> SerialTrans;
-  std::map<const int, NetworkTransport> transports;
+  MessageSlab<NetworkTransport> transports;
 
   NetContainer *nc;
 
@@ -306,6 +321,9 @@ private:
   std::vector<boost::intrusive_ptr<Stat::StatLog2Histogram>> theAcceptWaitTimes;
 
   Stat::StatMax theMaxInfiniteBuffer;
+
+  // Cycle of the last drive, to account for cycles skipped while idle
+  uint64_t theLastDriveCycle;
 };
 
 } // End Namespace nNetwork
@@ -143,12 +143,14 @@ bool ChannelPort::dumpState(ostream &out) {
 //
 
 ChannelInputPort::ChannelInputPort(const int32_t bufferCount_, const int32_t channelLatency_,
-                                   NetSwitch *netSwitch_, NetNode *netNode_)
+                                   NetSwitch *netSwitch_, NetNode *netNode_,
+                                   NetActivity *activity_)
     : ChannelPort(bufferCount_) {
   channelLatency = channelLatency_;
   delayHead = delayTail = nullptr;
   netSwitch = netSwitch_;
   netNode = netNode_;
+  activity = activity_;
 }
 
 bool ChannelInputPort::insertMessage(MessageState *msg) {
@@ -169,9 +171,11 @@ bool ChannelInputPort::insertMessage(MessageState *msg) {
     msl->delay = currTime + channelLatency;
   }
 
-  // Insert into the ordered queue
+  // Insert into the ordered queue.  Only the head is ever waited on, so the
+  // port is scheduled when the queue goes from empty to non-empty.
   if (delayHead == nullptr) {
     delayHead = delayTail = msl;
+    activity->scheduleInputPort(this, msl->delay);
   } else {
     delayTail->next = msl;
     delayTail = msl;
@@ -210,6 +214,9 @@ bool ChannelInputPort::drive(void) {
     freeMessageStateList(oldNode);
   }
 
+  if (delayHead != nullptr)
+    activity->scheduleInputPort(this, delayHead->delay);
+
   return false;
 }
 
@@ -252,8 +259,10 @@ bool ChannelOutputPort::drive(void) {
 //////////////////////////////////////////////////////////////////////
 //
 
-Channel::Channel(const int32_t id_) {
+Channel::Channel(const int32_t id_, NetActivity *activity_) {
   id = id_;
+  activity = activity_;
+  active = false;
   busy = 0;
   localLatencyDivider = 1;
   state = CS_IDLE;
@@ -46,6 +46,7 @@
 #ifndef _NS_CHANNEL_HPP_
 #define _NS_CHANNEL_HPP_
 
+#include "netactivity.hpp"
 #include "netcommon.hpp"
 
 namespace nNetShim {
@@ -144,7 +145,7 @@ protected:
 class ChannelInputPort : public ChannelPort {
 public:
   ChannelInputPort(const int32_t bufferCount_, const int32_t channelLatency_, NetSwitch *netSwitch_,
-                   NetNode *netNode_);
+                   NetNode *netNode_, NetActivity *activity_);
 
 public:
   virtual ~ChannelInputPort() {
@@ -175,6 +176,8 @@ protected:
 
   NetSwitch *netSwitch;
   NetNode *netNode;
+
+  NetActivity *activity;
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -204,7 +207,7 @@ protected:
 
 class Channel {
 public:
-  Channel(const int32_t id_);
+  Channel(const int32_t id_, NetActivity *activity_);
   virtual ~Channel() {
   }
 
@@ -219,9 +222,17 @@ public:
 
   bool notifyWaitingMessage(void) {
     messagesWaiting++;
+    if (!active) {
+      active = true;
+      activity->addChannel(this);
+    }
     return false;
   }
 
+  bool isIdle(void) const {
+    return (state == CS_IDLE && messagesWaiting == 0);
+  }
+
   void setLocalLatencyDivider(const int32_t latency_) {
     localLatencyDivider = latency_;
   }
@@ -236,6 +247,11 @@ protected:
   ChannelInputPort *toPort;
 
   int32_t messagesWaiting;
+
+  NetActivity *activity;
+  bool active;
+
+  friend class NetActivity;
 };
 
 typedef ChannelInputPort *ChannelInputPortP;
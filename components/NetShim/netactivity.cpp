@@ -0,0 +1,179 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+
+#include "netactivity.hpp"
+#include "channel.hpp"
+#include "netnode.hpp"
+#include "netswitch.hpp"
+
+#include <algorithm>
+
+namespace nNetShim {
+
+NetActivity::NetActivity(void) : wheelTime(-1), wheelMask(0), wheelEntries(0) {
+  wheel.resize(1);
+}
+
+bool NetActivity::setMaxLatency(const int32_t maxLatency) {
+  int32_t size = 1;
+
+  assert(wheelEntries == 0);
+
+  // A message is never scheduled further ahead than the longest channel
+  // latency, so a wheel of that size never wraps onto a live slot.
+  while (size <= maxLatency)
+    size <<= 1;
+
+  wheel.clear();
+  wheel.resize(size);
+  wheelMask = size - 1;
+
+  return false;
+}
+
+bool NetActivity::driveSwitches(const int64_t driveCount) {
+  size_t i, kept = 0;
+
+  for (i = 0; i < activeSwitches.size(); i++) {
+    NetSwitch *sw = activeSwitches[i];
+
+    if (sw->drive(driveCount))
+      return true;
+
+    if (sw->isIdle())
+      sw->active = false;
+    else
+      activeSwitches[kept++] = sw;
+  }
+
+  activeSwitches.resize(kept);
+  return false;
+}
+
+bool NetActivity::driveInputPorts(void) {
+  int64_t t;
+
+  if (wheelEntries == 0) {
+    wheelTime = currTime;
+    return false;
+  }
+
+  // Visit every slot that came due since the last call, at most one full turn
+  t = wheelTime + 1;
+  if (currTime - t > wheelMask)
+    t = currTime - wheelMask;
+
+  for (; t <= currTime; t++) {
+    std::vector<WheelEntry> &slot = wheel[t & wheelMask];
+
+    if (slot.empty())
+      continue;
+
+    // Ports reschedule themselves from drive(), possibly into this slot
+    wheelScratch.swap(slot);
+
+    for (const WheelEntry &entry : wheelScratch) {
+      if (entry.readyTime > currTime) {
+        wheel[t & wheelMask].push_back(entry);
+        continue;
+      }
+
+      wheelEntries--;
+      if (entry.port->drive())
+        return true;
+    }
+
+    wheelScratch.clear();
+  }
+
+  wheelTime = currTime;
+  return false;
+}
+
+bool NetActivity::driveChannels(void) {
+  size_t i, kept = 0;
+
+  for (i = 0; i < activeChannels.size(); i++) {
+    Channel *channel = activeChannels[i];
+
+    if (channel->drive())
+      return true;
+
+    if (channel->isIdle())
+      channel->active = false;
+    else
+      activeChannels[kept++] = channel;
+  }
+
+  activeChannels.resize(kept);
+  return false;
+}
+
+bool NetActivity::driveNodes(void) {
+  size_t i, kept = 0, count;
+
+  // Deliver in node order, as the full sweep did.  Nodes that get messages
+  // while we deliver (through the callbacks) are picked up next cycle.
+  std::sort(activeNodes.begin(), activeNodes.end(),
+            [](const NetNode *a, const NetNode *b) { return a->nodeId < b->nodeId; });
+
+  count = activeNodes.size();
+  for (i = 0; i < count; i++) {
+    NetNode *node = activeNodes[i];
+
+    if (node->drive())
+      return true;
+
+    if (node->messagesWaiting == 0)
+      node->active = false;
+    else
+      activeNodes[kept++] = node;
+  }
+
+  activeNodes.erase(activeNodes.begin() + kept, activeNodes.begin() + count);
+  return false;
+}
+
+} // namespace nNetShim
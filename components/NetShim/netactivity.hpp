@@ -0,0 +1,120 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+
+#ifndef _NS_NETACTIVITY_HPP_
+#define _NS_NETACTIVITY_HPP_
+
+#include "netcommon.hpp"
+
+#include <vector>
+
+namespace nNetShim {
+
+class Channel;
+class ChannelInputPort;
+class NetSwitch;
+class NetNode;
+
+// Per-cycle work lists for NetContainer::drive().  Components register
+// themselves when they get work (a message waiting, a transfer in progress)
+// and are dropped again once they go idle, so a cycle only touches the parts
+// of the network that have something to do.  Input ports holding messages in
+// their delay queue sit in a timing wheel keyed by the head message's
+// arrival time.
+class NetActivity {
+public:
+  NetActivity(void);
+
+public:
+  bool setMaxLatency(const int32_t maxLatency);
+
+  void addChannel(Channel *channel) {
+    activeChannels.push_back(channel);
+  }
+
+  void addSwitch(NetSwitch *sw) {
+    activeSwitches.push_back(sw);
+  }
+
+  void addNode(NetNode *node) {
+    activeNodes.push_back(node);
+  }
+
+  void scheduleInputPort(ChannelInputPort *port, const int64_t readyTime) {
+    WheelEntry entry = {readyTime, port};
+    wheel[readyTime & wheelMask].push_back(entry);
+    wheelEntries++;
+  }
+
+  bool isIdle(void) const {
+    return (activeSwitches.empty() && activeChannels.empty() && activeNodes.empty() &&
+            wheelEntries == 0);
+  }
+
+  bool driveSwitches(const int64_t driveCount);
+  bool driveInputPorts(void);
+  bool driveChannels(void);
+  bool driveNodes(void);
+
+protected:
+  struct WheelEntry {
+    int64_t readyTime;
+    ChannelInputPort *port;
+  };
+
+  std::vector<NetSwitch *> activeSwitches;
+  std::vector<Channel *> activeChannels;
+  std::vector<NetNode *> activeNodes;
+
+  std::vector<std::vector<WheelEntry>> wheel;
+  std::vector<WheelEntry> wheelScratch;
+
+  int64_t wheelTime;
+  int32_t wheelMask, wheelEntries;
+};
+
+} // namespace nNetShim
+
+#endif /* _NS_NETACTIVITY_HPP_ */
@@ -60,6 +60,7 @@ MessageStateList *msFreeList = nullptr;
 #define ALLOCATION_BLOCK_SIZE (512)
 
 int32_t msSerial = 0;
+int32_t msSlots = 0;
 
 MessageStateList *allocMessageStateList(void) {
   MessageStateList *newNode;
@@ -128,8 +129,10 @@ MessageState *allocMessageState(void) {
     // TODO: Value initialization is done in the constructor
     // memset(newState, 0, sizeof(MessageState[ALLOCATION_BLOCK_SIZE]));
 
-    for (i = 0; i < ALLOCATION_BLOCK_SIZE; i++)
+    for (i = 0; i < ALLOCATION_BLOCK_SIZE; i++) {
+      newState[i].slot = msSlots++;
       freeMessageState(&newState[i]);
+    }
   }
 
   assert(msFreeList != nullptr);
@@ -169,4 +172,8 @@ bool resetMessageStateSerial(void) {
   return false;
 }
 
+int32_t getMessageStateSlots(void) {
+  return msSlots;
+}
+
 } // namespace nNetShim
@@ -49,6 +49,7 @@
 #include <iostream>
 #include <limits.h>
 #include <stdio.h>
+#include <vector>
 
 #ifdef NS_STANDALONE
 
@@ -107,7 +108,7 @@ public:
   MessageState(void)
       : srcNode(-1), destNode(-1), priority(-1), networkVC(-1), nextHop(-1), nextVC(-1),
         transmitLatency(0), flexusInFastMode(false), hopCount(-1), bufferTime(0), atHeadTime(0),
-        acceptTime(0), startTS(0),
+        acceptTime(0), startTS(0), slot(-1),
   // CMU-ONLY-BLOCK-BEGIN
 #ifdef NS_STANDALONE
         replTS(0),
@@ -120,7 +121,7 @@ public:
                int32_t flexusInFastMode_)
       : srcNode(srcNode_), destNode(destNode_), priority(priority_), networkVC(0), nextHop(-1),
         nextVC(-1), transmitLatency(transmitLatency_), flexusInFastMode(flexusInFastMode_),
-        hopCount(-1), bufferTime(0), atHeadTime(0), acceptTime(0), startTS(0),
+        hopCount(-1), bufferTime(0), atHeadTime(0), acceptTime(0), startTS(0), slot(-1),
   // CMU-ONLY-BLOCK-BEGIN
 #ifdef NS_STANDALONE
         replTS(0),
@@ -180,6 +181,8 @@ public:
                        * channel contention/hot spot channels.
                        */
   int64_t startTS;    /* When did this message enter the network? */
+
+  int32_t slot; /* Dense id of this MessageState object, recycled with it */
   // CMU-ONLY-BLOCK-BEGIN
 #ifdef NS_STANDALONE
   int64_t replTS;
@@ -228,6 +231,46 @@ MessageState *allocMessageState(void);
 bool freeMessageState(MessageState *msg);
 bool resetMessageStateSerial(void);
 
+// Number of MessageState objects ever allocated (an upper bound on slot ids)
+int32_t getMessageStateSlots(void);
+
+// Per-message data kept outside the simulator (e.g. the Flexus transport),
+// stored in a flat array indexed by MessageState::slot.  Slots are recycled
+// through the MessageState free list, so the array stays as small as the
+// peak number of messages in flight.
+template <class T> class MessageSlab {
+public:
+  MessageSlab(void) : inFlight(0) {
+  }
+
+  void insert(const MessageState *msg, const T &value) {
+    assert(msg->slot >= 0);
+    if (msg->slot >= static_cast<int32_t>(entries.size()))
+      entries.resize(getMessageStateSlots());
+    entries[msg->slot] = value;
+    inFlight++;
+  }
+
+  T &operator[](const MessageState *msg) {
+    return entries[msg->slot];
+  }
+
+  // Drops the reference held in the slot; the slot itself goes back to
+  // the free list with its MessageState.
+  void erase(const MessageState *msg) {
+    entries[msg->slot] = T();
+    inFlight--;
+  }
+
+  bool empty(void) const {
+    return (inFlight == 0);
+  }
+
+private:
+  std::vector<T> entries;
+  int32_t inFlight;
+};
+
 #ifdef NS_DEBUG
 
 #ifdef NS_STANDALONE
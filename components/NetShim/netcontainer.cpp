@@ -46,7 +46,9 @@
 #include "netcontainer.hpp"
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string.h>
+#include <vector>
 
 namespace nNetShim {
 
@@ -78,7 +80,8 @@ const TokenMap topTokens[] = {
     {"SWITCHBANDWIDTH", VALIDATE_BEFORE, NetContainer::handleSwitchBandwidth},
     {"SWITCHPORTS", VALIDATE_BEFORE, NetContainer::handleSwitchPorts},
     {"TOP", VALIDATE_AFTER, NetContainer::handleTopology},
-    {"ROUTE", VALIDATE_AFTER, NetContainer::handleRoute}};
+    {"ROUTE", VALIDATE_AFTER, NetContainer::handleRoute},
+    {"GENERATE", VALIDATE_BEFORE, NetContainer::handleGenerate}};
 
 const char STR_NODE[] = "NODE";
 const char STR_TO[] = "->";
@@ -88,18 +91,31 @@ const char STR_CLOSECURLY[] = "}";
 
 #define TOP_TOKEN_COUNT (sizeof(topTokens) / sizeof(TokenMap))
 
+const char *generatedTopologies[] = {"MESH", "TORUS", "RING", "FLATTENEDBUTTERFLY"};
+
+#define GENERATED_TOPOLOGY_COUNT (sizeof(generatedTopologies) / sizeof(const char *))
+
 NetContainer::NetContainer(void)
     : channels(nullptr), switches(nullptr), nodes(nullptr), mslHead(nullptr), activeMessages(0),
 
       channelLatency(-1), channelLatencyData(-1), channelLatencyControl(-1), channelBandwidth(-1),
       localChannelLatencyDivider(-1), numNodes(-1), numSwitches(-1), switchInputBuffers(-1),
       switchOutputBuffers(-1), switchInternalBuffersPerVC(-1), switchBandwidth(-1), switchPorts(-1),
-      numChannels(0), maxChannelIndex(-1), openFiles(0) {
+      numChannels(0), maxChannelIndex(-1), openFiles(0), driveCount(0) {
 }
 
 bool NetContainer::buildNetwork(const char *filename) {
   ifstream infile;
 
+  // A topology spec instead of a file name builds the network directly
+  if (isGeneratedTopology(filename)) {
+    if (applyGeneratedDefaults() || generateTopology(filename) || validateNetwork()) {
+      std::cerr << "NetShim: error generating topology: \"" << filename << "\"" << endl;
+      return true;
+    }
+    return false;
+  }
+
   infile.open(filename);
 
   if (!infile.good()) {
@@ -339,38 +355,30 @@ retry:
 }
 
 bool NetContainer::drive(void) {
-  int i;
-
 #ifndef NS_STANDALONE
 #ifdef NS_DEBUG
   currTime++;
 #endif
 #endif
-  for (i = 0; i < numSwitches; i++) {
-    if (switches[i]->drive())
-      return true;
-  }
+  driveCount++;
 
-  // Drive the input ports first
-  for (i = 0; i < numSwitches; i++) {
-    if (switches[i]->driveInputPorts())
-      return true;
-  }
+  // Nothing in flight and no channel still busy: nothing to do this cycle
+  if (activity.isIdle())
+    return false;
 
-  for (i = 0; i < numNodes; i++) {
-    if (nodes[i]->driveInputPorts())
-      return true;
-  }
+  // Same phase order as a full sweep: switches, input ports (switch and
+  // node), channels, then nodes, but only over the components with work.
+  if (activity.driveSwitches(driveCount - 1))
+    return true;
 
-  for (i = 0; i < maxChannelIndex; i++) {
-    if (channels[i]->drive())
-      return true;
-  }
+  if (activity.driveInputPorts())
+    return true;
 
-  for (i = 0; i < numNodes; i++) {
-    if (nodes[i]->drive())
-      return true;
-  }
+  if (activity.driveChannels())
+    return true;
+
+  if (activity.driveNodes())
+    return true;
 
   return false;
 }
@@ -500,58 +508,66 @@ bool NetContainer::handleTopology(istream &infile, NetContainer *nc) {
     return true;
   }
 
-  if (nc->maxChannelIndex >= (nc->numChannels - 1)) {
-    std::cerr << "ERROR: too many channels specified!" << endl;
-    return true;
-  }
-
   // If we have a node, we'll always make it the source
   // and the switch the destination (order doesn't really matter in the
   // topology, but this makes the file format more flexible).
-  //
-  // Similarly for Node->SWITCH connections, we explicitly set the latency on
-  // the switch side to be the local delay.
   if (!(fromSwitch && toSwitch)) {
 
     if (fromSwitch) {
       assert(!toSwitch);
-      cerr << "Attaching node ";
-      if (attachNodeChannels(nc, node[1]))
-        return true;
-      cerr << " to switch ";
-      if (attachSwitchChannels(nc, sw[0], port[0], true))
-        return true;
-      cerr << endl;
-
-      if (nc->switches[sw[0]]->setLocalDelayOnly(port[0]))
+      if (nc->connectNodeToSwitch(node[1], sw[0], port[0]))
         return true;
+      cerr << "Attaching node " << node[1] << " to switch " << sw[0] << ":" << port[0] << endl;
 
     } else {
       assert(toSwitch);
-      cerr << "Attaching node ";
-      if (attachNodeChannels(nc, node[0]))
-        return true;
-      cerr << " to switch ";
-      if (attachSwitchChannels(nc, sw[1], port[1], true))
-        return true;
-      cerr << endl;
-
-      if (nc->switches[sw[1]]->setLocalDelayOnly(port[1]))
+      if (nc->connectNodeToSwitch(node[0], sw[1], port[1]))
         return true;
+      cerr << "Attaching node " << node[0] << " to switch " << sw[1] << ":" << port[1] << endl;
     }
 
   } else {
 
-    cerr << "Attaching switch ";
-    if (attachSwitchChannels(nc, sw[0], port[0], false))
-      return true;
-    cerr << " to switch ";
-    if (attachSwitchChannels(nc, sw[1], port[1], true))
+    if (nc->connectSwitches(sw[0], port[0], sw[1], port[1]))
       return true;
-    cerr << endl;
+    cerr << "Attaching switch " << sw[0] << ":" << port[0] << " to switch " << sw[1] << ":"
+         << port[1] << endl;
+  }
+
+  return false;
+}
+
+bool NetContainer::connectNodeToSwitch(const int32_t node, const int32_t sw, const int32_t port) {
+  if (maxChannelIndex >= (numChannels - 1)) {
+    std::cerr << "ERROR: too many channels specified!" << endl;
+    return true;
+  }
+
+  if (attachNodeChannels(this, node) || attachSwitchChannels(this, sw, port, true))
+    return true;
+
+  // For Node->SWITCH connections, we explicitly set the latency on
+  // the switch side to be the local delay.
+  if (switches[sw]->setLocalDelayOnly(port))
+    return true;
+
+  maxChannelIndex += 2;
+
+  return false;
+}
+
+bool NetContainer::connectSwitches(const int32_t sw0, const int32_t port0, const int32_t sw1,
+                                   const int32_t port1) {
+  if (maxChannelIndex >= (numChannels - 1)) {
+    std::cerr << "ERROR: too many channels specified!" << endl;
+    return true;
   }
 
-  nc->maxChannelIndex += 2;
+  if (attachSwitchChannels(this, sw0, port0, false) ||
+      attachSwitchChannels(this, sw1, port1, true))
+    return true;
+
+  maxChannelIndex += 2;
 
   return false;
 }
@@ -570,7 +586,6 @@ bool NetContainer::attachSwitchChannels(NetContainer *nc, const int32_t sw, cons
     goto error;
   }
 
-  std::cerr << sw << ":" << port;
   return false;
 
 error:
@@ -588,8 +603,6 @@ bool NetContainer::attachNodeChannels(NetContainer *nc, const int32_t node) {
   nc->channels[nc->maxChannelIndex]->setLocalLatencyDivider(nc->localChannelLatencyDivider);
   nc->channels[nc->maxChannelIndex + 1]->setLocalLatencyDivider(nc->localChannelLatencyDivider);
 
-  std::cerr << node;
-
   return false;
 
 error:
@@ -674,6 +687,204 @@ bool NetContainer::handleRoute(istream &infile, NetContainer *nc) {
   return false;
 }
 
+bool NetContainer::handleGenerate(istream &infile, NetContainer *nc) {
+  std::string spec;
+
+  // The spec runs to the end of the line, minus any trailing comment
+  getline(infile, spec);
+  spec = spec.substr(0, spec.find('#'));
+
+  return nc->generateTopology(spec);
+}
+
+bool NetContainer::isGeneratedTopology(const char *spec) {
+  std::istringstream in(spec);
+  std::string kind;
+  uint32_t i;
+
+  in >> kind;
+
+  for (i = 0; i < GENERATED_TOPOLOGY_COUNT; i++) {
+    if (strcasecmp(generatedTopologies[i], kind.c_str()) == 0)
+      return true;
+  }
+
+  return false;
+}
+
+bool NetContainer::applyGeneratedDefaults(void) {
+#define DEFAULT_PARAM(VAR, VAL)                                                                    \
+  if ((VAR) < 0)                                                                                   \
+    VAR = VAL;
+
+  // Same boilerplate the topology generators in testing/ emit
+  DEFAULT_PARAM(channelLatency, 100);
+  DEFAULT_PARAM(channelLatencyData, 32);
+  DEFAULT_PARAM(channelLatencyControl, 1);
+  DEFAULT_PARAM(localChannelLatencyDivider, 8);
+  DEFAULT_PARAM(switchInputBuffers, 5);
+  DEFAULT_PARAM(switchOutputBuffers, 1);
+  DEFAULT_PARAM(switchInternalBuffersPerVC, 1);
+  DEFAULT_PARAM(switchBandwidth, 4);
+
+#undef DEFAULT_PARAM
+
+  return false;
+}
+
+bool NetContainer::generateTopology(const std::string &spec) {
+  std::istringstream in(spec);
+  std::string kind, dims, order;
+
+  int32_t width = 0, height = 1, perRouter = 1, ports, x, y, c, r, i, next,
+          xMinus = -1, xPlus = -1, yMinus = -1, yPlus = -1;
+
+  bool torus = false, butterfly = false, yFirst = false, parsed;
+
+  in >> kind >> dims;
+
+  // Ring K[:N] is a Kx1 torus; everything else is WxH[:N]
+  if (strcasecmp(kind.c_str(), "RING") == 0) {
+    torus = true;
+    parsed = sscanf(dims.c_str(), "%d:%d", &width, &perRouter) >= 1;
+  } else {
+    torus = (strcasecmp(kind.c_str(), "TORUS") == 0);
+    butterfly = (strcasecmp(kind.c_str(), "FLATTENEDBUTTERFLY") == 0);
+    parsed = sscanf(dims.c_str(), "%dx%d:%d", &width, &height, &perRouter) >= 2;
+  }
+
+  if (!parsed || width <= 0 || height <= 0 || perRouter <= 0) {
+    std::cerr << "ERROR: cannot parse dimensions \"" << dims << "\" of " << kind << " topology"
+              << endl;
+    return true;
+  }
+
+  if (in >> order) {
+    if (strcasecmp(order.c_str(), "YX") == 0) {
+      yFirst = true;
+    } else if (strcasecmp(order.c_str(), "XY") != 0) {
+      std::cerr << "ERROR: expected XY or YX routing order, not \"" << order << "\"" << endl;
+      return true;
+    }
+  }
+
+  // Local nodes take the low ports, then the network ports of each dimension
+  next = perRouter;
+  if (butterfly) {
+    next += (width - 1) + (height - 1);
+  } else {
+    if (width > 1) {
+      xMinus = next++;
+      xPlus = next++;
+    }
+    if (height > 1) {
+      yMinus = next++;
+      yPlus = next++;
+    }
+  }
+  ports = next;
+
+  if (numNodes > 0 && numNodes != width * height * perRouter) {
+    std::cerr << "ERROR: NumNodes " << numNodes << " does not match " << kind << " " << dims
+              << endl;
+    return true;
+  }
+
+  numNodes = width * height * perRouter;
+  numSwitches = width * height;
+  if (switchPorts < ports)
+    switchPorts = ports;
+
+  if (validateParameters()) {
+    std::cerr << "ERROR: bad or missing parameters before generated topology" << endl;
+    return true;
+  }
+
+  if (allocateNetworkStructures()) {
+    std::cerr << "ERROR: allocating network structures." << endl;
+    return true;
+  }
+
+  for (i = 0; i < numNodes; i++) {
+    if (connectNodeToSwitch(i, i / perRouter, i % perRouter))
+      return true;
+  }
+
+  std::vector<ComputedRoute> xRoutes(width), yRoutes(height);
+
+  for (r = 0; r < numSwitches; r++) {
+    x = r % width;
+    y = r / width;
+
+    // Links are created from the lower coordinate (or the wrap-around) side
+    if (butterfly) {
+      for (c = x + 1; c < width; c++) {
+        if (connectSwitches(r, perRouter + c - 1, y * width + c, perRouter + x))
+          return true;
+      }
+      for (c = y + 1; c < height; c++) {
+        if (connectSwitches(r, perRouter + width - 1 + c - 1, c * width + x,
+                            perRouter + width - 1 + y))
+          return true;
+      }
+    } else {
+      if (width > 1 && (torus || x + 1 < width)) {
+        if (connectSwitches(r, xPlus, y * width + (x + 1) % width, xMinus))
+          return true;
+      }
+      if (height > 1 && (torus || y + 1 < height)) {
+        if (connectSwitches(r, yPlus, ((y + 1) % height) * width + x, yMinus))
+          return true;
+      }
+    }
+
+    // Dimension-order routes.  Tori go the short way around and use the
+    // dateline VC scheme: VC 0 while the wrap-around link is still ahead,
+    // VC 1 after it (or if it is never crossed).
+    for (c = 0; c < width; c++) {
+      ComputedRoute &route = xRoutes[c];
+      route.vc = 0;
+      if (butterfly) {
+        route.port = perRouter + (c < x ? c : c - 1);
+      } else if (torus && ((c - x + width) % width) <= width / 2) {
+        route.port = xPlus;
+        route.vc = (c > x);
+      } else if (torus) {
+        route.port = xMinus;
+        route.vc = (c < x);
+      } else {
+        route.port = (c < x ? xMinus : xPlus);
+      }
+    }
+
+    for (c = 0; c < height; c++) {
+      ComputedRoute &route = yRoutes[c];
+      route.vc = 0;
+      if (butterfly) {
+        route.port = perRouter + width - 1 + (c < y ? c : c - 1);
+      } else if (torus && ((c - y + height) % height) <= height / 2) {
+        route.port = yPlus;
+        route.vc = (c > y);
+      } else if (torus) {
+        route.port = yMinus;
+        route.vc = (c < y);
+      } else {
+        route.port = (c < y ? yMinus : yPlus);
+      }
+    }
+
+    if (switches[r]->setComputedRoutes(perRouter, width, height, yFirst, xRoutes.data(),
+                                       yRoutes.data()))
+      return true;
+  }
+
+  std::cerr << "NetShim: generated " << kind << " " << width << "x" << height << " with "
+            << perRouter << " node(s) per router, " << (yFirst ? "YX" : "XY") << " routing"
+            << endl;
+
+  return false;
+}
+
 bool NetContainer::allocateNetworkStructures(void) {
   int i;
 
@@ -685,16 +896,20 @@ bool NetContainer::allocateNetworkStructures(void) {
   numChannels = (numSwitches * switchPorts) * 2;
   maxChannelIndex = 0;
 
+  if (activity.setMaxLatency(channelLatency))
+    return true;
+
   // Allocate channel array
   channels = new ChannelP[numChannels];
   for (i = 0; i < numChannels; i++)
-    channels[i] = new Channel(i);
+    channels[i] = new Channel(i, &activity);
 
   // Allocate switch array
   switches = new NetSwitchP[numSwitches];
   for (i = 0; i < numSwitches; i++) {
     switches[i] = new NetSwitch(i, numNodes, switchPorts, switchInputBuffers, switchOutputBuffers,
-                                switchInternalBuffersPerVC, switchBandwidth, channelLatency);
+                                switchInternalBuffersPerVC, switchBandwidth, channelLatency,
+                                &activity);
   }
 
   nodes = new NetNodeP[numNodes];
@@ -47,9 +47,12 @@
 #define _NS_NETCONTAINER_HPP_
 
 #include "channel.hpp"
+#include "netactivity.hpp"
 #include "netnode.hpp"
 #include "netswitch.hpp"
 
+#include <string>
+
 #ifndef NS_STANDALONE
 #include <functional>
 #endif
@@ -66,6 +69,16 @@ public:
 
   bool drive(void);
 
+  bool isIdle(void) const {
+    return activity.isIdle();
+  }
+
+  // Account for cycles in which drive() was not called because the network
+  // was idle, so that switch arbitration matches a cycle-by-cycle run
+  void skipIdleCycles(const int64_t cycles) {
+    driveCount += cycles;
+  }
+
 public:
   static bool handleInclude(istream &infile, NetContainer *nc);
   static bool handleChannelLatency(istream &infile, NetContainer *nc);
@@ -82,6 +95,7 @@ public:
   static bool handleSwitchPorts(istream &infile, NetContainer *nc);
   static bool handleTopology(istream &infile, NetContainer *nc);
   static bool handleRoute(istream &infile, NetContainer *nc);
+  static bool handleGenerate(istream &infile, NetContainer *nc);
 
   static bool readTopSrcDest(istream &file, bool &isSwitch, int32_t &node, int32_t &sw,
                              int32_t &port, NetContainer *nc);
@@ -100,6 +114,10 @@ public:
 
   static bool attachNodeChannels(NetContainer *nc, const int32_t node);
 
+  NetActivity *getActivity(void) {
+    return &activity;
+  }
+
   bool networkEmpty(void) const {
     return (mslHead == nullptr);
   }
@@ -131,6 +149,9 @@ public:
   int32_t getMaximumInfiniteBufferDepth(void) {
     int i, depth, maxDepth = 0;
 
+    if (activeMessages == 0)
+      return 0;
+
     for (i = 0; i < numNodes; i++) {
       depth = nodes[i]->getInfiniteBufferUsed();
       if (depth > maxDepth)
@@ -176,6 +197,16 @@ protected:
 
   bool allocateNetworkStructures(void);
 
+  // Built-in parametric topologies: "Mesh WxH[:N] [XY|YX]", "Torus WxH[:N] [XY|YX]",
+  // "Ring K[:N]" and "FlattenedButterfly WxH[:N] [XY|YX]", N nodes per router.
+  static bool isGeneratedTopology(const char *spec);
+  bool applyGeneratedDefaults(void);
+  bool generateTopology(const std::string &spec);
+
+  bool connectNodeToSwitch(const int32_t node, const int32_t sw, const int32_t port);
+  bool connectSwitches(const int32_t sw0, const int32_t port0, const int32_t sw1,
+                       const int32_t port1);
+
 protected:
   ChannelP *channels;
 
@@ -192,6 +223,11 @@ protected:
       // Internally generated state
       numChannels, maxChannelIndex, openFiles;
 
+  NetActivity activity;
+
+  // Number of calls to drive(), for switch arbitration
+  int64_t driveCount;
+
 #ifndef NS_STANDALONE
   std::function<bool(const int, const int)> isNodeAvailablePtr;
   std::function<bool(const MessageState *)> deliverMessagePtr;
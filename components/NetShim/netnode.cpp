@@ -49,9 +49,18 @@
 namespace nNetShim {
 
 NetNode::NetNode(const int32_t nodeId_, NetContainer *nc_)
-    : nodeId(nodeId_), nc(nc_), messagesWaiting(0) {
+    : nodeId(nodeId_), nc(nc_), messagesWaiting(0), active(false) {
   fromNodePort = new ChannelOutputPort(INT_MAX);
-  toNodePort = new ChannelInputPort(1, 1, nullptr, this);
+  toNodePort = new ChannelInputPort(1, 1, nullptr, this, nc->getActivity());
+}
+
+bool NetNode::notifyWaitingMessage(void) {
+  messagesWaiting++;
+  if (!active) {
+    active = true;
+    nc->getActivity()->addNode(this);
+  }
+  return false;
 }
 
 bool NetNode::drive(void) {
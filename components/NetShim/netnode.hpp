@@ -75,10 +75,6 @@ public:
 
   bool drive(void);
 
-  bool driveInputPorts(void) {
-    return toNodePort->drive();
-  }
-
   bool checkTopology(void) const;
 
   bool dumpState(ostream &out);
@@ -102,10 +98,7 @@ public:
     return fromNodePort->hasBufferSpace(vc);
   }
 
-  bool notifyWaitingMessage(void) {
-    messagesWaiting++;
-    return false;
-  }
+  bool notifyWaitingMessage(void);
 
 protected:
   int32_t nodeId;
@@ -116,6 +109,10 @@ protected:
   ChannelInputPort *toNodePort;
 
   int32_t messagesWaiting;
+
+  bool active;
+
+  friend class NetActivity;
 };
 
 typedef NetNode *NetNodeP;
@@ -59,11 +59,12 @@ NetSwitch::NetSwitch(const int32_t name_,     // Name/id of the switch
                      const int32_t numPorts_, // Number of ports/bidirectional channels on the sw
                      const int32_t inputBufferDepth_, const int32_t outputBufferDepth_,
                      const int32_t vcBufferDepth_, const int32_t crossbarBandwidth_,
-                     const int32_t channelLatency_)
+                     const int32_t channelLatency_, NetActivity *activity_)
     : name(name_), numNodes(numNodes_), numPorts(numPorts_), inputBufferDepth(inputBufferDepth_),
       outputBufferDepth(outputBufferDepth_), vcBufferDepth(vcBufferDepth_),
-      crossbarBandwidth(crossbarBandwidth_), nextStartingPort(0) {
-  int i, j;
+      crossbarBandwidth(crossbarBandwidth_), nextStartingPort(0), activity(activity_),
+      active(false) {
+  int i;
 
   // Check basic assumptions for switch parameters
   assert(numNodes > 0);
@@ -78,12 +79,28 @@ NetSwitch::NetSwitch(const int32_t name_,     // Name/id of the switch
   outputPorts = new ChannelOutputPortP[numPorts];
 
   for (i = 0; i < numPorts; i++) {
-    inputPorts[i] = new ChannelInputPort(inputBufferDepth, channelLatency_, this, nullptr);
+    inputPorts[i] =
+        new ChannelInputPort(inputBufferDepth, channelLatency_, this, nullptr, activity);
     outputPorts[i] = new ChannelOutputPort(outputBufferDepth);
   }
 
   internalBuffer = new NetSwitchInternalBuffer(vcBufferDepth, this);
 
+  // The per-destination routing table is allocated on the first explicit
+  // route, so generated topologies never pay numNodes entries per switch.
+  routingTable = vcTable = nullptr;
+  xRoutes = yRoutes = nullptr;
+  nodesPerRouter = gridWidth = gridHeight = 1;
+  gridX = gridY = 0;
+  yFirst = false;
+
+  for (i = 0; i < MAX_VC; i++)
+    messagesWaiting[i] = 0;
+}
+
+bool NetSwitch::allocateRoutingTable(void) {
+  int32_t i, j;
+
   // Initialize the routing table to bogus values.  We can't route yet.
   routingTable = new intP[numNodes];
   vcTable = new intP[numNodes];
@@ -96,8 +113,33 @@ NetSwitch::NetSwitch(const int32_t name_,     // Name/id of the switch
     }
   }
 
-  for (i = 0; i < MAX_VC; i++)
-    messagesWaiting[i] = 0;
+  return false;
+}
+
+bool NetSwitch::setComputedRoutes(const int32_t nodesPerRouter_, const int32_t gridWidth_,
+                                  const int32_t gridHeight_, const bool yFirst_,
+                                  const ComputedRoute *xRoutes_, const ComputedRoute *yRoutes_) {
+  int32_t i;
+
+  assert(nodesPerRouter_ > 0 && gridWidth_ > 0 && gridHeight_ > 0);
+  assert(name < gridWidth_ * gridHeight_);
+
+  nodesPerRouter = nodesPerRouter_;
+  gridWidth = gridWidth_;
+  gridHeight = gridHeight_;
+  gridX = name % gridWidth;
+  gridY = name / gridWidth;
+  yFirst = yFirst_;
+
+  xRoutes = new ComputedRoute[gridWidth];
+  yRoutes = new ComputedRoute[gridHeight];
+
+  for (i = 0; i < gridWidth; i++)
+    xRoutes[i] = xRoutes_[i];
+  for (i = 0; i < gridHeight; i++)
+    yRoutes[i] = yRoutes_[i];
+
+  return false;
 }
 
 bool NetSwitch::attachChannel(Channel *channel, const int32_t port, const bool isInput) {
@@ -129,11 +171,13 @@ ostream &operator<<(ostream &os, const ChannelPortPrinter &printer) {
   return os;
 }
 
-bool NetSwitch::drive(void) {
+bool NetSwitch::drive(const int64_t driveCount) {
   MessageState *msg;
 
   int32_t vc, currPort, bandwidthRemaining = crossbarBandwidth;
 
+  nextStartingPort = driveCount % numPorts;
+
   // For once and for all, here is the prioritized, no inversion, fair
   // arbitration algorithm:
   //
@@ -202,8 +246,6 @@ bool NetSwitch::drive(void) {
 
   } // For each vc
 
-  nextStartingPort = (nextStartingPort + 1) % numPorts;
-
   return false;
 }
 
@@ -224,18 +266,25 @@ bool NetSwitch::sendMessageToOutput(MessageState *msg) {
   return false;
 }
 
-bool NetSwitch::driveInputPorts(void) {
-  int32_t i;
+bool NetSwitch::routingPolicy(MessageState *msg) {
+  int32_t i, routingPort, routingVC;
 
-  for (i = 0; i < numPorts; i++)
-    if (inputPorts[i]->drive())
-      return true;
+  if (xRoutes != nullptr) {
+    const ComputedRoute route = computeRoute(msg->destNode);
 
-  return false;
-}
+    if (outputPorts[route.port]->hasBufferSpace(BUILD_VC(msg->priority, route.vc))) {
+      msg->nextHop = route.port;
+      msg->nextVC = BUILD_VC(msg->priority, route.vc);
+      TRACE(msg, " SW" << name << " routing destination " << msg->destNode << " to port "
+                       << route.port << ":" << route.vc << " (priority = " << msg->priority);
+      return false;
+    }
 
-bool NetSwitch::routingPolicy(MessageState *msg) {
-  int32_t i, routingPort, routingVC;
+    return true;
+  }
+
+  if (routingTable == nullptr)
+    return true;
 
   // Search for an available and acceptable output port, if any
   for (i = 0; i < numPorts * MAX_NET_VC; i++) {
@@ -288,10 +337,28 @@ bool NetSwitch::checkRoutingTable(void) const {
 
   bool foundErrors = false;
 
+  if (xRoutes != nullptr) {
+    for (i = 0; i < numNodes; i++) {
+      const ComputedRoute route = computeRoute(i);
+
+      if (route.port < 0 || route.port >= numPorts || !outputPorts[route.port]->isConnected()) {
+        std::cerr << "ERROR: computed route to node " << i << " exiting switch " << name
+                  << " on unconnected port " << route.port << ":" << route.vc << endl;
+        foundErrors = true;
+      }
+    }
+
+    return foundErrors;
+  }
+
+  if (routingTable == nullptr) {
+    std::cerr << "ERROR: partitioned network possible: Switch " << name
+              << " has no routing table entries" << endl;
+    return true;
+  }
+
   // The most basic test we can make is to see that each
   // node has at least one valid routing entry
-  assert(routingTable);
-
   for (i = 0; i < numNodes; i++) {
 
     if (routingTable[i][0] == -1) {
@@ -322,6 +389,9 @@ bool NetSwitch::addRoutingEntry(const int32_t node, const int32_t port, const in
   assert(port < numPorts && port >= 0);
   assert(vc < MAX_NET_VC && vc >= 0);
 
+  if (routingTable == nullptr)
+    allocateRoutingTable();
+
   for (i = 0; i < numPorts * MAX_NET_VC; i++) {
     if (routingTable[node][i] == port && vcTable[node][i] == vc) {
       std::cerr << "WARNING: duplicate routing entry for switch " << name << " to node " << node
@@ -53,6 +53,11 @@ namespace nNetShim {
 // Forward declaration
 class NetSwitch;
 
+// One hop of a computed route: output port and network VC
+struct ComputedRoute {
+  int16_t port, vc;
+};
+
 class NetSwitchInternalBuffer {
 public:
   NetSwitchInternalBuffer(const int32_t bufferCount_, NetSwitch *netSwitch_);
@@ -128,13 +133,25 @@ public:
             const int32_t numPorts_, // Number of ports/bidirectional channels
             const int32_t inputBufferDepth_, const int32_t outputBufferDepth_,
             const int32_t vcBufferDepth_, const int32_t crossbarBandwidth_,
-            const int32_t channelLatency_);
+            const int32_t channelLatency_, NetActivity *activity_);
   virtual ~NetSwitch() {
   }
 
 public:
-  bool drive(void);
-  bool driveInputPorts(void);
+  // driveCount is the number of network cycles driven so far; it sets the
+  // round-robin starting port even if this switch sat idle for a while.
+  bool drive(const int64_t driveCount);
+
+  bool isIdle(void) const {
+    int32_t vc;
+
+    for (vc = 0; vc < MAX_VC; vc++) {
+      if (messagesWaiting[vc])
+        return false;
+    }
+
+    return !internalBuffer->hasMessage();
+  }
 
   bool attachChannel(Channel *channel, const int32_t port, const bool isInput);
 
@@ -143,6 +160,13 @@ public:
 
   bool addRoutingEntry(const int32_t destNode, const int32_t outPort, const int32_t outVC);
 
+  // Table-free routing for generated grid topologies.  The destination node is
+  // decoded into router coordinates and each dimension is looked up in a small
+  // array indexed by the destination coordinate in that dimension.
+  bool setComputedRoutes(const int32_t nodesPerRouter_, const int32_t gridWidth_,
+                         const int32_t gridHeight_, const bool yFirst_,
+                         const ComputedRoute *xRoutes_, const ComputedRoute *yRoutes_);
+
   bool dumpState(ostream &out, const int32_t flags);
 
   // These ports give the minimum delay possible - reserved for the local node
@@ -150,6 +174,10 @@ public:
 
   bool notifyWaitingMessage(const int32_t vc) {
     messagesWaiting[vc]++;
+    if (!active) {
+      active = true;
+      activity->addSwitch(this);
+    }
     return false;
   }
 
@@ -158,6 +186,28 @@ protected:
 
   bool sendMessageToOutput(MessageState *msg);
 
+  bool allocateRoutingTable(void);
+
+  inline ComputedRoute computeRoute(const int32_t destNode) const {
+    const int32_t router = destNode / nodesPerRouter;
+    const int32_t x = router % gridWidth, y = router / gridWidth;
+
+    if (yFirst) {
+      if (y != gridY)
+        return yRoutes[y];
+      if (x != gridX)
+        return xRoutes[x];
+    } else {
+      if (x != gridX)
+        return xRoutes[x];
+      if (y != gridY)
+        return yRoutes[y];
+    }
+
+    ComputedRoute local = {static_cast<int16_t>(destNode % nodesPerRouter), 0};
+    return local;
+  }
+
 protected:
   int name, numNodes, numPorts, inputBufferDepth, outputBufferDepth, vcBufferDepth,
       crossbarBandwidth,
@@ -170,7 +220,17 @@ protected:
 
   int **routingTable, **vcTable;
 
+  // Computed routing state, used instead of the tables when xRoutes is set
+  ComputedRoute *xRoutes, *yRoutes;
+  int nodesPerRouter, gridWidth, gridHeight, gridX, gridY;
+  bool yFirst;
+
   int messagesWaiting[MAX_VC];
+
+  NetActivity *activity;
+  bool active;
+
+  friend class NetActivity;
 };
 
 typedef NetSwitch *NetSwitchP;
@@ -110,7 +110,7 @@ struct EffectChain {
   }
 };
 
-struct DependanceTarget {
+struct DependanceTarget : public nuArchARM::DependanceSink {
   void invokeSatisfy(int32_t anArg);
   void invokeSquash(int32_t anArg) {
     squash(anArg);
@@ -49,20 +49,159 @@
 #include <core/boost_extensions/intrusive_ptr.hpp>
 #include <iostream>
 
+#include <core/pool_alloc.hpp>
 #include <core/stats.hpp>
 #include <core/types.hpp>
 // MARK
 #include <exception>
 #include <vector>
 
-static const size_t kICBSize = 2048;
+// Component slots reserved up front by each ICB.  An instruction has a few
+// dozen components at most, so reserving room for 2048 only cost a 16KB
+// allocation per decoded instruction.
+static const size_t kICBSize = 32;
 
 namespace narmDecoder {
 extern Flexus::Stat::StatCounter theICBs;
 
+// Slab allocator for instruction components.  Components are carved out of
+// large slabs in fixed size classes and go back to the current thread's free
+// list of their class when the owning ICB is destroyed (on retire or squash),
+// so steady-state decode does not touch the general heap.  As in
+// Flexus::Core::SlabPool, the free lists trade batches with a shared depot, so
+// components freed on a different thread than the one that decoded them are
+// reused rather than piling up.  Live and peak bytes and slabs are published
+// as sys-Pool-ComponentArena-* stats.
+struct ComponentArena {
+  static const size_t kQuantum = 16;
+  static const size_t kMaxSize = 1024;
+  static const size_t kClasses = kMaxSize / kQuantum + 1;
+  static const size_t kSlabSize = 256 * 1024;
+  static const size_t kBatch = 32;
+
+  static void *allocate(size_t aSize) {
+    if (aSize > kMaxSize) {
+      return ::operator new(aSize);
+    }
+    size_t cls = sizeClass(aSize);
+    ThreadCache &local = cache();
+    if (!local.theFreeLists[cls]) {
+      refill(local, cls);
+    }
+    FreeBlock *block = local.theFreeLists[cls];
+    local.theFreeLists[cls] = block->theNext;
+    --local.theFreeCounts[cls];
+    depot().theCounters.allocated(cls * kQuantum);
+    return block;
+  }
+
+  static void deallocate(void *aPtr, size_t aSize) {
+    if (aSize > kMaxSize) {
+      ::operator delete(aPtr);
+      return;
+    }
+    size_t cls = sizeClass(aSize);
+    ThreadCache &local = cache();
+    FreeBlock *block = static_cast<FreeBlock *>(aPtr);
+    block->theNext = local.theFreeLists[cls];
+    local.theFreeLists[cls] = block;
+    if (++local.theFreeCounts[cls] >= 2 * kBatch) {
+      spill(local, cls);
+    }
+    depot().theCounters.released(cls * kQuantum);
+  }
+
+private:
+  struct FreeBlock {
+    FreeBlock *theNext;
+  };
+
+  struct ThreadCache {
+    FreeBlock *theFreeLists[kClasses];
+    size_t theFreeCounts[kClasses];
+    char *theSlabCursor;
+    size_t theSlabRemaining;
+  };
+
+  struct Depot {
+    std::mutex theLock;
+    std::vector<FreeBlock *> theBatches[kClasses];
+    Flexus::Core::PoolCounters theCounters;
+    Depot() : theCounters(typeid(ComponentArena).name()) {
+    }
+  };
+
+  static ThreadCache &cache() {
+    static thread_local ThreadCache theCache = {};
+    return theCache;
+  }
+  static Depot &depot() {
+    static Depot theDepot;
+    return theDepot;
+  }
+
+  static size_t sizeClass(size_t aSize) {
+    return (aSize + kQuantum - 1) / kQuantum;
+  }
+
+  static void refill(ThreadCache &aCache, size_t aClass) {
+    Depot &shared = depot();
+    {
+      std::lock_guard<std::mutex> lock(shared.theLock);
+      if (!shared.theBatches[aClass].empty()) {
+        aCache.theFreeLists[aClass] = shared.theBatches[aClass].back();
+        aCache.theFreeCounts[aClass] = kBatch;
+        shared.theBatches[aClass].pop_back();
+        return;
+      }
+    }
+    for (size_t i = 0; i < kBatch; ++i) {
+      FreeBlock *block = static_cast<FreeBlock *>(carve(aCache, aClass * kQuantum));
+      block->theNext = aCache.theFreeLists[aClass];
+      aCache.theFreeLists[aClass] = block;
+    }
+    aCache.theFreeCounts[aClass] = kBatch;
+  }
+
+  static void spill(ThreadCache &aCache, size_t aClass) {
+    FreeBlock *batch = aCache.theFreeLists[aClass];
+    FreeBlock *last = batch;
+    for (size_t i = 1; i < kBatch; ++i) {
+      last = last->theNext;
+    }
+    aCache.theFreeLists[aClass] = last->theNext;
+    aCache.theFreeCounts[aClass] -= kBatch;
+    last->theNext = nullptr;
+    Depot &shared = depot();
+    std::lock_guard<std::mutex> lock(shared.theLock);
+    shared.theBatches[aClass].push_back(batch);
+  }
+
+  // Slabs are carved by the thread that owns the cache and never released
+  static void *carve(ThreadCache &aCache, size_t aSize) {
+    if (aCache.theSlabRemaining < aSize) {
+      // The tail of the old slab is abandoned
+      aCache.theSlabCursor = static_cast<char *>(::operator new(kSlabSize));
+      aCache.theSlabRemaining = kSlabSize;
+      depot().theCounters.theSlabs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void *block = aCache.theSlabCursor;
+    aCache.theSlabCursor += aSize;
+    aCache.theSlabRemaining -= aSize;
+    return block;
+  }
+};
+
 struct UncountedComponent {
   virtual ~UncountedComponent() {
   } // MARK: for calling effect/action destructors
+
+  static void *operator new(size_t aSize) {
+    return ComponentArena::allocate(aSize);
+  }
+  static void operator delete(void *aPtr, size_t aSize) {
+    ComponentArena::deallocate(aPtr, aSize);
+  }
 };
 
 // MARK: rewrite this to explicitly track components being added to an instruction
@@ -75,7 +75,7 @@ namespace narmDecoder {
 
 using namespace nuArchARM;
 
-struct ReadRegisterAction : public BaseSemanticAction {
+struct ReadRegisterAction : public BaseSemanticAction, public BypassConsumer {
   eOperandCode theRegisterCode;
   eOperandCode theOperandCode;
   bool theConnected;
@@ -143,8 +143,7 @@ struct ReadRegisterAction : public BaseSemanticAction {
         mapped_reg name = theInstruction->operand<mapped_reg>(theRegisterCode);
         setReady(0, core()->requestRegister(
                         name, theInstruction->makeInstructionDependance(dependance())) == kReady);
-        core()->connectBypass(name, theInstruction,
-                              ll::bind(&ReadRegisterAction::bypass, this, ll::_1));
+        core()->connectBypass(name, theInstruction, this);
         theConnected = true;
       }
       if (!signalled()) {
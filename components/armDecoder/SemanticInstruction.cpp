@@ -43,6 +43,7 @@
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //  DO-NOT-REMOVE end-copyright-block
 
+#include <algorithm>
 #include <list>
 
 #include <boost/bind.hpp>
@@ -150,10 +151,8 @@ SemanticInstruction::makeInstructionDependance(InternalDependance const &aDepend
   DBG_Assert(reinterpret_cast<long>(aDependance.theTarget) != 0x1);
   nuArchARM::InstructionDependance ret_val;
   ret_val.instruction = boost::intrusive_ptr<nuArchARM::Instruction>(this);
-  ret_val.satisfy =
-      boost::bind(&DependanceTarget::invokeSatisfy, aDependance.theTarget, aDependance.theArg);
-  ret_val.squash =
-      boost::bind(&DependanceTarget::invokeSquash, aDependance.theTarget, aDependance.theArg);
+  ret_val.target = aDependance.theTarget;
+  ret_val.arg = aDependance.theArg;
   return ret_val;
 }
 
@@ -193,10 +192,8 @@ void SemanticInstruction::setCanRetireCounter(const uint32_t numCycles) {
   theCanRetireCounter = numCycles;
 }
 
-void SemanticInstruction::decrementCanRetireCounter() {
-  if (theCanRetireCounter > 0) {
-    --theCanRetireCounter;
-  }
+void SemanticInstruction::decrementCanRetireCounter(uint32_t aCycles) {
+  theCanRetireCounter -= std::min(theCanRetireCounter, aCycles);
 }
 
 InternalDependance SemanticInstruction::retirementDependance() {
@@ -117,7 +117,7 @@ private:
 
 public:
   void setCanRetireCounter(const uint32_t numCycles);
-  void decrementCanRetireCounter();
+  void decrementCanRetireCounter(uint32_t aCycles);
 
   SemanticInstruction(VirtualMemoryAddress aPC, Opcode anOpcode,
                       boost::intrusive_ptr<BPredState> bp_state, uint32_t aCPU,
@@ -55,6 +55,7 @@
 
 #include <boost/weak_ptr.hpp>
 #include <components/MTManager/MTManager.hpp>
+#include <core/dormancy.hpp>
 
 namespace ll = boost::lambda;
 
@@ -76,6 +77,9 @@ class FLEXUS_COMPONENT(armDecoder) {
 
   bool theSyncInsnInProgress;
 
+  // Nothing was dispatched last cycle; set until something is pushed here
+  bool theBlocked;
+
 public:
   FLEXUS_COMPONENT_CONSTRUCTOR(armDecoder) : base(FLEXUS_PASS_CONSTRUCTOR_ARGS) {
   }
@@ -85,9 +89,20 @@ public:
     return theFIQ.empty() && !theSyncInsnInProgress;
   }
 
+  uint64_t nextEventCycle() const {
+    // A blocked decoder waits for fetched instructions or for the core to free
+    // ROB space, which the core reports as its own work
+    if (!cfg.Multithread &&
+        (theBlocked || Flexus::Core::CoreDormancy::dormancy().isDormant(flexusIndex()))) {
+      return UINT64_MAX;
+    }
+    return 0;
+  }
+
   void initialize() {
     theInsnSequenceNo = 0;
     theSyncInsnInProgress = false;
+    theBlocked = false;
   }
 
   void finalize() {
@@ -96,6 +111,7 @@ public:
 public:
   FLEXUS_PORT_ALWAYS_AVAILABLE(FetchBundleIn);
   void push(interface::FetchBundleIn const &, pFetchBundle &aBundle) {
+    theBlocked = false;
     std::list<tFillLevel>::iterator fill_iter = aBundle->theFillLevels.begin();
     for (auto it = aBundle->theOpcodes.begin(); it != aBundle->theOpcodes.end(); it++) {
       int32_t uop = 0;
@@ -144,6 +160,7 @@ public:
 
   FLEXUS_PORT_ALWAYS_AVAILABLE(SquashIn);
   void push(interface::SquashIn const &, eSquashCause &aReason) {
+    theBlocked = false;
     DBG_(VVerb, Comp(*this)(<< "DISPATCH SQUASH: " << aReason
                             << " FIQ discarding: " << theFIQ.size() << " instructions"));
     theFIQ.clear();
@@ -159,7 +176,7 @@ public:
       if (nMTManager::MTManager::get()->runThisD(flexusIndex())) {
         doDecode();
       }
-    } else {
+    } else if (!Flexus::Core::CoreDormancy::dormancy().isDormant(flexusIndex())) {
       doDecode();
     }
     //}
@@ -229,6 +246,7 @@ private:
       ++dispatched;
       --available_dispatch;
     }
+    theBlocked = (dispatched == 0);
 
     DISPATCH_DBG("--------------FINISH DISPATCHING------------------------");
   }
@@ -121,7 +121,7 @@ public:
 
   virtual void setCanRetireCounter(const uint32_t numCycles) {
   }
-  virtual void decrementCanRetireCounter() {
+  virtual void decrementCanRetireCounter(uint32_t aCycles) {
   }
 
   virtual void connectuArch(uArchARM &auArch) {
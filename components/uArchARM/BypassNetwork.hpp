@@ -46,11 +46,11 @@
 #ifndef FLEXUS_uARCH_BYPASSNETWORK_HPP_INCLUDED
 #define FLEXUS_uARCH_BYPASSNETWORK_HPP_INCLUDED
 
+#include "ConsumerTable.hpp"
 #include "uArchInterfaces.hpp"
 #include <algorithm>
 #include <boost/lambda/bind.hpp>
 #include <boost/lambda/lambda.hpp>
-#include <list>
 #include <vector>
 namespace ll = boost::lambda;
 namespace nuArchARM {
@@ -60,10 +60,16 @@ protected:
   uint32_t theXRegs;
   uint32_t theVRegs;
   uint32_t theCCRegs;
-  typedef std::function<bool(register_value)> bypass_fn;
-  typedef std::pair<boost::intrusive_ptr<Instruction>, bypass_fn> bypass_handle;
-  typedef std::list<bypass_handle> bypass_handle_list;
-  typedef std::vector<bypass_handle_list> bypass_map;
+  struct bypass_handle {
+    boost::intrusive_ptr<Instruction> theInstruction;
+    BypassConsumer *theConsumer;
+    bypass_handle() : theConsumer(0) {
+    }
+    bypass_handle(boost::intrusive_ptr<Instruction> anInstruction, BypassConsumer *aConsumer)
+        : theInstruction(anInstruction), theConsumer(aConsumer) {
+    }
+  };
+  typedef ConsumerTable<bypass_handle> bypass_map;
   typedef std::vector<int32_t> collect_counter;
   bypass_map theXDeps;
   collect_counter theXCounts;
@@ -72,37 +78,27 @@ protected:
   bypass_map theCCDeps;
   collect_counter theCCCounts;
 
+  static bool isComplete(bypass_handle const &aHandle) {
+    return aHandle.theInstruction->isComplete();
+  }
+
 public:
   BypassNetwork(uint32_t anXRegs, uint32_t anVRegs, uint32_t anCCRegs)
       : theXRegs(anXRegs), theVRegs(anVRegs), theCCRegs(anCCRegs) {
     reset();
   }
 
-  void doCollect(bypass_handle_list &aList) {
-    FLEXUS_PROFILE();
-    bypass_handle_list::iterator iter, temp, end;
-    iter = aList.begin();
-    end = aList.end();
-    while (iter != end) {
-      temp = iter;
-      ++iter;
-      if (temp->first->isComplete()) {
-        aList.erase(temp);
-      }
-    }
-  }
-
-  bypass_handle_list &lookup(mapped_reg anIndex) {
+  bypass_map &lookup(mapped_reg anIndex) {
     switch (anIndex.theType) {
     case xRegisters:
-      return theXDeps[anIndex.theIndex];
+      return theXDeps;
     case vRegisters:
-      return theVDeps[anIndex.theIndex];
+      return theVDeps;
     case ccBits:
-      return theCCDeps[anIndex.theIndex];
+      return theCCDeps;
     default:
       DBG_Assert(false);
-      return theXDeps[0]; // Suppress compiler warning
+      return theXDeps; // Suppress compiler warning
     }
   }
 
@@ -112,21 +108,21 @@ public:
       --theXCounts[anIndex.theIndex];
       if (theXCounts[anIndex.theIndex] <= 0) {
         theXCounts[anIndex.theIndex] = 10;
-        doCollect(theXDeps[anIndex.theIndex]);
+        theXDeps.visit(anIndex.theIndex, isComplete);
       }
       break;
     case vRegisters:
       --theVCounts[anIndex.theIndex];
       if (theVCounts[anIndex.theIndex] <= 0) {
         theVCounts[anIndex.theIndex] = 10;
-        doCollect(theVDeps[anIndex.theIndex]);
+        theVDeps.visit(anIndex.theIndex, isComplete);
       }
       break;
     case ccBits:
       --theCCCounts[anIndex.theIndex];
       if (theCCCounts[anIndex.theIndex] <= 0) {
         theCCCounts[anIndex.theIndex] = 10;
-        doCollect(theCCDeps[anIndex.theIndex]);
+        theCCDeps.visit(anIndex.theIndex, isComplete);
       }
       break;
     default:
@@ -138,23 +134,20 @@ public:
     FLEXUS_PROFILE();
     for (uint32_t i = 0; i < theXRegs; ++i) {
       theXCounts[i] = 10;
-      doCollect(theXDeps[i]);
+      theXDeps.visit(i, isComplete);
     }
     for (uint32_t i = 0; i < theVRegs; ++i) {
       theVCounts[i] = 10;
-      doCollect(theVDeps[i]);
+      theVDeps.visit(i, isComplete);
     }
     for (uint32_t i = 0; i < theCCRegs; ++i) {
       theCCCounts[i] = 10;
-      doCollect(theCCDeps[i]);
+      theCCDeps.visit(i, isComplete);
     }
   }
 
   void reset() {
     FLEXUS_PROFILE();
-    theXDeps.clear();
-    theVDeps.clear();
-    theCCDeps.clear();
     theXDeps.resize(theXRegs);
     theVDeps.resize(theVRegs);
     theCCDeps.resize(theCCRegs);
@@ -166,30 +159,22 @@ public:
     theCCCounts.resize(theCCRegs, 10);
   }
 
-  void connect(mapped_reg anIndex, boost::intrusive_ptr<Instruction> inst, bypass_fn fn) {
+  void connect(mapped_reg anIndex, boost::intrusive_ptr<Instruction> inst,
+               BypassConsumer *aConsumer) {
     FLEXUS_PROFILE();
     collect(anIndex);
-    lookup(anIndex).push_back(std::make_pair(inst, fn));
+    lookup(anIndex).push(anIndex.theIndex, bypass_handle(inst, aConsumer));
   }
   void unmap(mapped_reg anIndex) {
     FLEXUS_PROFILE();
-    lookup(anIndex).clear();
+    lookup(anIndex).clear(anIndex.theIndex);
   }
 
   void write(mapped_reg anIndex, register_value aValue, uArchARM &aCore) {
     FLEXUS_PROFILE();
-    bypass_handle_list &list = lookup(anIndex);
-    bypass_handle_list::iterator iter = list.begin();
-    bypass_handle_list::iterator end = list.end();
-    while (iter != end) {
-      if (iter->second(aValue)) {
-        auto temp = iter;
-        ++iter;
-        list.erase(temp);
-      } else {
-        ++iter;
-      }
-    }
+    lookup(anIndex).visit(anIndex.theIndex, [&aValue](bypass_handle const &aHandle) {
+      return aHandle.theConsumer->bypass(aValue);
+    });
   }
 };
 
@@ -0,0 +1,94 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+
+#ifndef FLEXUS_uARCH_COMMITBATCH_HPP_INCLUDED
+#define FLEXUS_uARCH_COMMITBATCH_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+namespace nuArchARM {
+
+// Committed instructions that QEMU has yet to execute.  QEMU executes the
+// whole batch in one advance and may stop early on an exception, so only the
+// prefix it executed is handed back to the core.
+template <class Insn> class CommitBatch {
+  std::vector<Insn> theInsns;
+
+public:
+  bool empty() const {
+    return theInsns.empty();
+  }
+  size_t size() const {
+    return theInsns.size();
+  }
+  Insn const &front() const {
+    return theInsns.front();
+  }
+  void push(Insn const &anInsn) {
+    theInsns.push_back(anInsn);
+  }
+  void clear() {
+    theInsns.clear();
+  }
+
+  // Execute the batch with anAdvance(count, executed), then call
+  // aRetire(insn, raised) on each executed instruction, oldest first.  Only the
+  // last one can have raised.  Returns the exception anAdvance reported and
+  // leaves the batch empty.
+  template <class Advance, class Retire> int drain(Advance anAdvance, Retire aRetire) {
+    int32_t executed = 0;
+    int raised = anAdvance(static_cast<int32_t>(theInsns.size()), executed);
+    for (int32_t i = 0; i < executed; ++i) {
+      aRetire(theInsns[i], raised != 0 && i == executed - 1);
+    }
+    theInsns.clear();
+    return raised;
+  }
+};
+
+} // namespace nuArchARM
+
+#endif // FLEXUS_uARCH_COMMITBATCH_HPP_INCLUDED
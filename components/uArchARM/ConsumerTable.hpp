@@ -0,0 +1,154 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+
+#ifndef FLEXUS_uARCH_CONSUMERTABLE_HPP_INCLUDED
+#define FLEXUS_uARCH_CONSUMERTABLE_HPP_INCLUDED
+
+#include <deque>
+#include <vector>
+
+namespace nuArchARM {
+
+// Per-register consumer chains for wakeup.  Consumers live in slots threaded
+// through small integer links, so registering and releasing a consumer never
+// allocates once the table has warmed up.  Slots are kept in a deque so that a
+// consumer visited by visit() stays valid if the visitor registers new ones.
+template <class Entry> class ConsumerTable {
+  struct Slot {
+    Entry theEntry;
+    int32_t theNext;
+  };
+
+  std::vector<int32_t> theHeads;
+  std::vector<int32_t> theTails;
+  std::deque<Slot> theSlots;
+  int32_t theFree;
+
+  void release(int32_t aSlot) {
+    theSlots[aSlot].theEntry = Entry();
+    theSlots[aSlot].theNext = theFree;
+    theFree = aSlot;
+  }
+
+public:
+  ConsumerTable() : theFree(-1) {
+  }
+
+  void resize(uint32_t aRegs) {
+    theHeads.assign(aRegs, -1);
+    theTails.assign(aRegs, -1);
+    theSlots.clear();
+    theFree = -1;
+  }
+
+  uint32_t size() const {
+    return theHeads.size();
+  }
+
+  void clear() {
+    resize(theHeads.size());
+  }
+
+  void clear(uint32_t aReg) {
+    int32_t slot = theHeads[aReg];
+    while (slot >= 0) {
+      int32_t next = theSlots[slot].theNext;
+      release(slot);
+      slot = next;
+    }
+    theHeads[aReg] = theTails[aReg] = -1;
+  }
+
+  bool empty(uint32_t aReg) const {
+    return theHeads[aReg] < 0;
+  }
+
+  void push(uint32_t aReg, Entry const &anEntry) {
+    int32_t slot = theFree;
+    if (slot >= 0) {
+      theFree = theSlots[slot].theNext;
+      theSlots[slot].theEntry = anEntry;
+    } else {
+      slot = theSlots.size();
+      theSlots.push_back(Slot{anEntry, -1});
+    }
+    theSlots[slot].theNext = -1;
+    if (theTails[aReg] < 0) {
+      theHeads[aReg] = slot;
+    } else {
+      theSlots[theTails[aReg]].theNext = slot;
+    }
+    theTails[aReg] = slot;
+  }
+
+  // Calls aVisitor on each consumer of aReg in registration order, releasing
+  // the consumers for which it returns true.
+  template <class Visitor> void visit(uint32_t aReg, Visitor aVisitor) {
+    int32_t prev = -1;
+    int32_t slot = theHeads[aReg];
+    while (slot >= 0) {
+      bool done = aVisitor(theSlots[slot].theEntry);
+      int32_t next = theSlots[slot].theNext;
+      if (done) {
+        if (prev < 0) {
+          theHeads[aReg] = next;
+        } else {
+          theSlots[prev].theNext = next;
+        }
+        if (theTails[aReg] == slot) {
+          theTails[aReg] = prev;
+        }
+        release(slot);
+      } else {
+        prev = slot;
+      }
+      slot = next;
+    }
+  }
+};
+
+} // namespace nuArchARM
+
+#endif // FLEXUS_uARCH_CONSUMERTABLE_HPP_INCLUDED
@@ -1068,4 +1068,30 @@ void CoreImpl::skipCycle() {
   theTimeBreakdown.skipCycle();
 }
 
+// Cycles skipped while isMemoryStalled() held.  Nothing changed in them, so
+// each is accounted like the last modelled cycle.
+void CoreImpl::accountStalledCycles(uint64_t aCycles) {
+  theROBOccupancyTotal << std::make_pair(theROB.size(), aCycles);
+  theLSQOccupancy << std::make_pair(theLSQCount, aCycles);
+  theSBOccupancy << std::make_pair(theSBCount, aCycles);
+  theSBNAWOccupancy << std::make_pair(theSBNAWCount, aCycles);
+  theSBUniqueOccupancy << std::make_pair(theSBLines_Permission.size(), aCycles);
+  theSpeculativeCheckpoints << std::make_pair(theCheckpoints.size(), aCycles);
+  if (theSpinning) {
+    theROBOccupancySpin << std::make_pair(theROB.size(), aCycles);
+  } else {
+    theROBOccupancyNonSpin << std::make_pair(theROB.size(), aCycles);
+  }
+  theIdleCycleCount += aCycles;
+
+  rob_t::iterator i;
+  for (i = theROB.begin(); i != theROB.end(); ++i) {
+    i->get()->decrementCanRetireCounter(aCycles);
+  }
+}
+
+void CoreImpl::accountDormancy() {
+  theTimeBreakdown.idle(kTBIdle);
+}
+
 } // namespace nuArchARM
@@ -56,9 +56,13 @@ void CoreImpl::reschedule(boost::intrusive_ptr<SemanticAction> anAction) {
   theRescheduledActions.push(anAction);
 }
 
-bool ActionOrder::operator()(boost::intrusive_ptr<SemanticAction> const &l,
-                             boost::intrusive_ptr<SemanticAction> const &r) const {
-  return l->instructionNo() > r->instructionNo();
+void ActionWindow::push(boost::intrusive_ptr<SemanticAction> const &anAction) {
+  theActions.emplace_back(anAction->instructionNo(), anAction);
+}
+
+void ActionWindow::order() {
+  std::stable_sort(theActions.begin(), theActions.end(),
+                   [](entry_t const &l, entry_t const &r) { return l.first < r.first; });
 }
 
 } // namespace nuArchARM
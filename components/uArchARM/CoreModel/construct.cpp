@@ -54,7 +54,8 @@ namespace nuArchARM {
 CoreImpl::CoreImpl(uArchOptions_t options
                    //, std::function< void (Flexus::Qemu::Translation &) > xlat
                    ,
-                   std::function<int()> _advance, std::function<void(eSquashCause)> _squash,
+                   std::function<int(int32_t, int32_t &)> _advance,
+                   std::function<void(eSquashCause)> _squash,
                    std::function<void(VirtualMemoryAddress)> _redirect,
                    std::function<void(int, int)> _change_mode,
                    std::function<void(boost::intrusive_ptr<BranchFeedback>)> _feedback,
@@ -84,7 +85,11 @@ CoreImpl::CoreImpl(uArchOptions_t options
       theValuePredictInhibit(false), theIsSpeculating(false), theIsIdle(false),
       theRetiresSinceCheckpoint(0),
       theAllowedSpeculativeCheckpoints(options.speculativeCheckpoints),
-      theCheckpointThreshold(options.checkpointThreshold), theAbortSpeculation(false),
+      theCheckpointThreshold(options.checkpointThreshold), theCommitBatch(options.commitBatch),
+      theValidateInterval(options.validateInterval), theValidateSampled(options.validateSampled),
+      theValidateState(options.validateState), theCommitsToValidation(options.validateInterval),
+      theValidationDue(false), theValidateSeed(options.node * 2 + 1),
+      theAbortSpeculation(false),
       theTSOBReplayStalls(0), theSLATHits_Load(theName + "-SLATHits:Load"),
       theSLATHits_Store(theName + "-SLATHits:Store"),
       theSLATHits_Atomic(theName + "-SLATHits:Atomic"),
@@ -234,6 +239,9 @@ CoreImpl::CoreImpl(uArchOptions_t options
   // original constructor continues here...
   prepareMemOpAccounting();
 
+  theROB.reserve(theROBSize);
+  theMemQueueAddresses.reserve(theROBSize + theSBSize);
+
   std::vector<uint32_t> reg_file_sizes;
   reg_file_sizes.resize(kLastMapTableCode + 2);
   reg_file_sizes[xRegisters] = kxRegs_Total + 3 * theROBSize;
@@ -307,8 +315,8 @@ void CoreImpl::resetARM() {
 
   theBypassNetwork.reset();
 
-  theActiveActions = action_list_t();
-  theRescheduledActions = action_list_t();
+  theActiveActions.clear();
+  theRescheduledActions.clear();
 
   theDispatchInteractions.clear();
   thePreserveInteractions = false;
@@ -336,6 +344,7 @@ void CoreImpl::reset() {
   resetARM();
 
   theSRB.clear();
+  theBatch.clear();
 
   // theBranchFeedback is NOT cleared
 
@@ -482,7 +491,7 @@ void CoreImpl::setPC(uint64_t aPC) {
 CoreModel *CoreModel::construct(uArchOptions_t options
                                 //, std::function< void (Flexus::Qemu::Translation &) > translate
                                 ,
-                                std::function<int()> advance,
+                                std::function<int(int32_t, int32_t &)> advance,
                                 std::function<void(eSquashCause)> squash,
                                 std::function<void(VirtualMemoryAddress)> redirect,
                                 std::function<void(int, int)> change_mode,
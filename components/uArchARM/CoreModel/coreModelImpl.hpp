@@ -75,6 +75,7 @@ using namespace boost::multi_index;
 namespace Stat = Flexus::Stat;
 
 #include "../BypassNetwork.hpp"
+#include "../CommitBatch.hpp"
 #include "../MapTable.hpp"
 #include "../RegisterFile.hpp"
 #include "../coreModel.hpp"
@@ -116,7 +117,7 @@ class CoreImpl : public CoreModel {
   // Msutherl - removed translate as a call to microArch,
   // now internal to CoreModel
   // std::function< void (Flexus::Qemu::Translation &) > translate;
-  std::function<int()> advance_fn;
+  std::function<int(int32_t, int32_t &)> advance_fn;
   std::function<void(eSquashCause)> squash_fn;
   std::function<void(VirtualMemoryAddress)> redirect_fn;
   std::function<void(int, int)> change_mode_fn;
@@ -164,7 +165,6 @@ private:
 
   eExceptionType thePendingTrap;
   boost::intrusive_ptr<Instruction> theTrapInstruction;
-  std::string theFlexusDumpState, theQemuDumpState;
 
   // Bypass Network
   BypassNetwork theBypassNetwork;
@@ -214,6 +214,7 @@ private:
 
 public:
   memq_t theMemQueue;
+  MemQueueAddresses theMemQueueAddresses;
 
 private:
   int64_t theLSQCount;
@@ -267,6 +268,14 @@ private:
   int32_t theRetiresSinceCheckpoint;
   int32_t theAllowedSpeculativeCheckpoints;
   int32_t theCheckpointThreshold;
+  uint32_t theCommitBatch;
+  CommitBatch<boost::intrusive_ptr<Instruction>> theBatch;
+  uint32_t theValidateInterval;
+  bool theValidateSampled;
+  uint32_t theValidateState;
+  uint64_t theCommitsToValidation;
+  bool theValidationDue;
+  uint64_t theValidateSeed;
   bool theAbortSpeculation;
   int32_t theTSOBReplayStalls;
   boost::intrusive_ptr<Instruction> theViolatingInstruction;
@@ -516,7 +525,7 @@ public:
            // Msutherl, removed
            //, std::function< void (Flexus::Qemu::Translation &) > xlat
            ,
-           std::function<int()> advance, std::function<void(eSquashCause)> squash,
+           std::function<int(int32_t, int32_t &)> advance, std::function<void(eSquashCause)> squash,
            std::function<void(VirtualMemoryAddress)> redirect,
            std::function<void(int, int)> change_mode,
            std::function<void(boost::intrusive_ptr<BranchFeedback>)> feedback,
@@ -530,10 +539,23 @@ public:
   //==========================================================================
 public:
   void skipCycle();
+  bool isMemoryStalled() const;
+  void accountStalledCycles(uint64_t aCycles);
+  void accountDormancy();
   void cycle(eExceptionType aPendingInterrupt);
   std::string dumpState();
   bool checkValidatation();
 
+private:
+  bool mayBatchAdvance(boost::intrusive_ptr<Instruction> anInstruction);
+  void advanceBatched();
+  uint64_t nextValidation();
+  void getValidationState(armValidationState &aState);
+  void readValidationState(armValidationState &aState);
+  void diffValidationState(armValidationState const &aFlexus, armValidationState const &aQemu);
+
+public:
+
 private:
   void prepareCycle();
   void arbitrate();
@@ -541,8 +563,6 @@ private:
   void endCycle();
   void satisfy(InstructionDependance const &aDep);
   void squash(InstructionDependance const &aDep);
-  void satisfy(std::list<InstructionDependance> &dependances);
-  void squash(std::list<InstructionDependance> &dependances);
 
   void clearExclusiveLocal();
   void clearExclusiveGlobal();
@@ -664,7 +684,7 @@ public:
   //==========================================================================
   void bypass(mapped_reg aReg, register_value aValue);
   void connectBypass(mapped_reg aReg, boost::intrusive_ptr<Instruction> inst,
-                     std::function<bool(register_value)> fn);
+                     BypassConsumer *aConsumer);
 
   // Register File Interface
   //==========================================================================
@@ -747,6 +767,8 @@ public:
                  bool aBypassSB, InstructionDependance const &aDependance, eAccType type);
   void eraseLSQ(boost::intrusive_ptr<Instruction> anInsn);
   void cleanMSHRS(uint64_t aDiscardAfterSequenceNum);
+  void eraseMemQueue(memq_t::index<by_queue>::type::iterator aFirst,
+                     memq_t::index<by_queue>::type::iterator aLast);
   void clearLSQ();
   void clearSSB();
   int32_t clearSSB(uint64_t aStopAtInsnSeq);
@@ -834,15 +856,13 @@ public:
   // Value forwarding
   //==========================================================================
   void forwardValue(MemQueueEntry const &aStore, memq_t::index<by_insn>::type::iterator aLoad);
-  template <class Iter>
   boost::optional<memq_t::index<by_insn>::type::iterator>
-  snoopQueue(Iter iter, Iter end, memq_t::index<by_insn>::type::iterator load);
+  snoopQueue(memq_t::index<by_insn>::type::iterator load);
   boost::optional<memq_t::index<by_insn>::type::iterator>
   snoopStores(memq_t::index<by_insn>::type::iterator aLoad,
               boost::optional<memq_t::index<by_insn>::type::iterator> aCachedSnoopState);
   void updateDependantLoads(memq_t::index<by_insn>::type::iterator anUpdatedStore);
-  void applyStores(memq_t::index<by_paddr>::type::iterator aFirstStore,
-                   memq_t::index<by_paddr>::type::iterator aLastStore,
+  void applyStores(uint32_t aFirstSlot, uint32_t aLastSlot,
                    memq_t::index<by_insn>::type::iterator aLoad);
   void applyAllStores(memq_t::index<by_insn>::type::iterator aLoad);
 
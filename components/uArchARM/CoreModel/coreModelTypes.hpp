@@ -47,7 +47,9 @@
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <vector>
 
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/iterator/reverse_iterator.hpp>
 #include <boost/none.hpp>
 #include <boost/optional.hpp>
@@ -88,11 +90,167 @@ static const int32_t kxRegs_Total = kTotalRegs;
 static const int32_t kccRegs = 5;
 
 struct by_insn {};
-typedef multi_index_container<
-    boost::intrusive_ptr<Instruction>,
-    indexed_by<sequenced<>,
-               ordered_non_unique<tag<by_insn>, identity<boost::intrusive_ptr<Instruction>>>>>
-    rob_t;
+
+// Circular buffer of in-flight instructions in program order, used for the ROB
+// and SRB.  Positions are absolute and only ever increase, so iterators stay
+// valid across push_back() and pop_front() just like node-based iterators, and
+// end() is a distinguished position that remains end() as entries are added.
+class InstructionWindow {
+public:
+  typedef boost::intrusive_ptr<Instruction> value_type;
+
+private:
+  static const uint64_t kEnd = ~0ULL;
+  std::vector<value_type> theSlots; // size is always a power of two
+  uint64_t theHead;                 // absolute position of front()
+  uint64_t theTail;                 // absolute position one past back()
+
+  value_type &slot(uint64_t aPosition) {
+    return theSlots[aPosition & (theSlots.size() - 1)];
+  }
+  value_type const &slot(uint64_t aPosition) const {
+    return theSlots[aPosition & (theSlots.size() - 1)];
+  }
+
+  void resize(uint64_t aCapacity) {
+    std::vector<value_type> slots(aCapacity);
+    for (uint64_t i = theHead; i != theTail; ++i) {
+      slots[i & (aCapacity - 1)].swap(slot(i));
+    }
+    theSlots.swap(slots);
+  }
+
+public:
+  class iterator : public boost::iterator_facade<iterator, value_type const,
+                                                 boost::bidirectional_traversal_tag> {
+    friend class boost::iterator_core_access;
+    friend class InstructionWindow;
+    InstructionWindow const *theWindow;
+    uint64_t thePosition;
+
+    iterator(InstructionWindow const *aWindow, uint64_t aPosition)
+        : theWindow(aWindow), thePosition(aPosition) {
+    }
+    value_type const &dereference() const {
+      return theWindow->slot(thePosition);
+    }
+    bool equal(iterator const &anOther) const {
+      return thePosition == anOther.thePosition;
+    }
+    void increment() {
+      if (++thePosition == theWindow->theTail) {
+        thePosition = kEnd;
+      }
+    }
+    void decrement() {
+      thePosition = (thePosition == kEnd ? theWindow->theTail : thePosition) - 1;
+    }
+
+  public:
+    iterator() : theWindow(nullptr), thePosition(kEnd) {
+    }
+  };
+  typedef iterator const_iterator;
+  typedef boost::reverse_iterator<iterator> reverse_iterator;
+
+  InstructionWindow() : theSlots(64), theHead(0), theTail(0) {
+  }
+
+  void reserve(uint64_t aCapacity) {
+    uint64_t capacity = theSlots.size();
+    while (capacity < aCapacity) {
+      capacity *= 2;
+    }
+    if (capacity != theSlots.size()) {
+      resize(capacity);
+    }
+  }
+
+  bool empty() const {
+    return theHead == theTail;
+  }
+  size_t size() const {
+    return theTail - theHead;
+  }
+
+  iterator begin() const {
+    if (empty()) {
+      return end();
+    }
+    return iterator(this, theHead);
+  }
+  iterator end() const {
+    return iterator(this, kEnd);
+  }
+  reverse_iterator rbegin() const {
+    return reverse_iterator(end());
+  }
+  reverse_iterator rend() const {
+    return reverse_iterator(begin());
+  }
+
+  value_type const &front() const {
+    return slot(theHead);
+  }
+  value_type const &back() const {
+    return slot(theTail - 1);
+  }
+
+  void push_back(value_type const &anInsn) {
+    if (size() == theSlots.size()) {
+      resize(theSlots.size() * 2);
+    }
+    slot(theTail++) = anInsn;
+  }
+
+  void pop_front() {
+    slot(theHead++).reset();
+  }
+
+  // Only tail ranges are ever erased (squashes and speculation rollback)
+  void erase(iterator aFirst, iterator aLast) {
+    DBG_Assert(aLast == end());
+    if (aFirst == end()) {
+      return;
+    }
+    for (uint64_t i = aFirst.thePosition; i != theTail; ++i) {
+      slot(i).reset();
+    }
+    theTail = aFirst.thePosition;
+  }
+
+  void clear() {
+    while (!empty()) {
+      pop_front();
+    }
+  }
+
+  // Instructions enter the window in sequence number order, so anInsn is
+  // located by binary search; the linear scan only guards against
+  // out-of-order sequence numbers
+  iterator find(value_type const &anInsn) const {
+    uint64_t lo = theHead, hi = theTail;
+    int64_t seq = anInsn->sequenceNo();
+    while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (slot(mid)->sequenceNo() < seq) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    if (lo != theTail && slot(lo) == anInsn) {
+      return iterator(this, lo);
+    }
+    for (uint64_t i = theHead; i != theTail; ++i) {
+      if (slot(i) == anInsn) {
+        return iterator(this, i);
+      }
+    }
+    return end();
+  }
+};
+typedef InstructionWindow rob_t;
 
 typedef std::multimap<PhysicalMemoryAddress, boost::intrusive_ptr<Instruction>>
     SpeculativeLoadAddressTracker;
@@ -118,7 +276,7 @@ bool interruptASI(int32_t asi);
 
 struct MemQueueEntry {
   boost::intrusive_ptr<Instruction> theInstruction;
-  PhysicalMemoryAddress thePaddr_aligned;
+  mutable PhysicalMemoryAddress thePaddr_aligned;
   uint64_t theSequenceNum;
   eQueue theQueue;
   mutable VirtualMemoryAddress theVaddr;
@@ -244,7 +402,6 @@ struct MemQueueEntry {
   }
 };
 
-struct by_paddr {};
 struct by_seq {};
 struct by_queue {};
 struct by_prefetch {};
@@ -252,12 +409,6 @@ typedef multi_index_container<
     MemQueueEntry,
     indexed_by<
         sequenced<tag<by_seq>>,
-
-        ordered_unique<tag<by_paddr>, composite_key<MemQueueEntry,
-                                                    member<MemQueueEntry, PhysicalMemoryAddress,
-                                                           &MemQueueEntry::thePaddr_aligned>,
-                                                    member<MemQueueEntry, uint64_t,
-                                                           &MemQueueEntry::theSequenceNum>>>,
         ordered_unique<tag<by_insn>, member<MemQueueEntry, boost::intrusive_ptr<Instruction>,
                                             &MemQueueEntry::theInstruction>>,
         ordered_unique<
@@ -266,14 +417,171 @@ typedef multi_index_container<
                           member<MemQueueEntry, uint64_t, &MemQueueEntry::theSequenceNum>>>>>
     memq_t;
 
-struct ActionOrder {
-  bool operator()(boost::intrusive_ptr<SemanticAction> const &l,
-                  boost::intrusive_ptr<SemanticAction> const &r) const;
+// Aligned physical addresses of theMemQueue entries, packed in sequence order.
+// Replaces an ordered (address, sequence) index on memq_t: store forwarding and
+// alias checks become a linear scan over at most SBSize + ROBSize addresses,
+// and resolving an address no longer rebalances a tree.  Erased entries are
+// left as tombstones and squeezed out once they outnumber the live ones.
+class MemQueueAddresses {
+  static const uint64_t kDead = ~0ULL - 1; // never a valid aligned address
+  std::vector<uint64_t> theAddrs;
+  std::vector<uint64_t> theSeqs;
+  std::vector<memq_t::iterator> theEntries;
+  uint32_t theHead;
+  uint32_t theDead;
+
+  void compact() {
+    uint32_t out = 0;
+    for (uint32_t i = theHead; i < theAddrs.size(); ++i) {
+      if (theAddrs[i] != kDead) {
+        theAddrs[out] = theAddrs[i];
+        theSeqs[out] = theSeqs[i];
+        theEntries[out] = theEntries[i];
+        ++out;
+      }
+    }
+    theAddrs.resize(out);
+    theSeqs.resize(out);
+    theEntries.resize(out);
+    theHead = 0;
+    theDead = 0;
+  }
+
+public:
+  MemQueueAddresses() : theHead(0), theDead(0) {
+  }
+
+  void reserve(uint32_t aCapacity) {
+    theAddrs.reserve(aCapacity);
+    theSeqs.reserve(aCapacity);
+    theEntries.reserve(aCapacity);
+  }
+
+  uint32_t begin() const {
+    return theHead;
+  }
+  uint32_t end() const {
+    return theAddrs.size();
+  }
+  memq_t::iterator entry(uint32_t aSlot) const {
+    return theEntries[aSlot];
+  }
+
+  // First slot whose sequence number is >= aSeq
+  uint32_t lowerBound(uint64_t aSeq) const {
+    return std::lower_bound(theSeqs.begin() + theHead, theSeqs.end(), aSeq) - theSeqs.begin();
+  }
+
+  boost::optional<memq_t::iterator> find(uint64_t aSeq) const {
+    uint32_t slot = lowerBound(aSeq);
+    if (slot == end() || theSeqs[slot] != aSeq || theAddrs[slot] == kDead) {
+      return boost::none;
+    }
+    return theEntries[slot];
+  }
+
+  // anEntry must be the youngest entry in theMemQueue
+  void push_back(memq_t::iterator anEntry) {
+    DBG_Assert(theSeqs.empty() || theSeqs.back() < anEntry->theSequenceNum);
+    theAddrs.push_back(static_cast<uint64_t>(anEntry->thePaddr_aligned));
+    theSeqs.push_back(anEntry->theSequenceNum);
+    theEntries.push_back(anEntry);
+  }
+
+  void update(uint64_t aSeq, PhysicalMemoryAddress anAddr) {
+    uint32_t slot = lowerBound(aSeq);
+    DBG_Assert(slot != end() && theSeqs[slot] == aSeq && theAddrs[slot] != kDead);
+    theAddrs[slot] = static_cast<uint64_t>(anAddr);
+  }
+
+  void erase(uint64_t aSeq) {
+    uint32_t slot = lowerBound(aSeq);
+    DBG_Assert(slot != end() && theSeqs[slot] == aSeq && theAddrs[slot] != kDead);
+    theAddrs[slot] = kDead;
+    ++theDead;
+    // Entries mostly leave from the head (retirement) or the tail (squash)
+    while (theHead < end() && theAddrs[theHead] == kDead) {
+      ++theHead;
+      --theDead;
+    }
+    while (end() > theHead && theAddrs.back() == kDead) {
+      theAddrs.pop_back();
+      theSeqs.pop_back();
+      theEntries.pop_back();
+      --theDead;
+    }
+    if (theHead == end()) {
+      theAddrs.clear();
+      theSeqs.clear();
+      theEntries.clear();
+      theHead = 0;
+    } else if (theHead > end() / 2 || theDead > (end() - theHead) / 2) {
+      compact();
+    }
+  }
+
+  // First slot in [aSlot, anEnd) holding anAddr, or anEnd
+  uint32_t nextMatch(uint32_t aSlot, uint32_t anEnd, uint64_t anAddr) const {
+    uint64_t const *addrs = theAddrs.data();
+    for (; aSlot < anEnd; ++aSlot) {
+      if (addrs[aSlot] == anAddr) {
+        return aSlot;
+      }
+    }
+    return anEnd;
+  }
+
+  // One past the last slot in [aBegin, anEnd) holding anAddr, or aBegin
+  uint32_t prevMatch(uint32_t aBegin, uint32_t anEnd, uint64_t anAddr) const {
+    uint64_t const *addrs = theAddrs.data();
+    for (; anEnd > aBegin; --anEnd) {
+      if (addrs[anEnd - 1] == anAddr) {
+        return anEnd;
+      }
+    }
+    return aBegin;
+  }
+
+  // Appends (address, sequence) for every live entry with an aligned address
+  // in [aLow, aHigh]
+  void collect(uint64_t aLow, uint64_t aHigh,
+               std::vector<std::pair<uint64_t, uint64_t>> &aMatches) const {
+    for (uint32_t i = theHead; i < end(); ++i) {
+      if (theAddrs[i] - aLow <= aHigh - aLow) {
+        aMatches.push_back(std::make_pair(theAddrs[i], theSeqs[i]));
+      }
+    }
+  }
+};
+
+// Actions made ready for one cycle.  Each action is tagged with its
+// instruction's age when it is scheduled; order() sorts the window once so the
+// cycle can walk it oldest first, with actions of one instruction kept in the
+// order they were scheduled.
+class ActionWindow {
+  typedef std::pair<int64_t, boost::intrusive_ptr<SemanticAction>> entry_t;
+  std::vector<entry_t> theActions;
+
+public:
+  typedef std::vector<entry_t>::iterator iterator;
+
+  void push(boost::intrusive_ptr<SemanticAction> const &anAction);
+  void order();
+  bool empty() const {
+    return theActions.empty();
+  }
+  void clear() {
+    theActions.clear();
+  }
+  iterator begin() {
+    return theActions.begin();
+  }
+  iterator end() {
+    return theActions.end();
+  }
 };
 
-typedef std::priority_queue<boost::intrusive_ptr<SemanticAction>,
-                            std::vector<boost::intrusive_ptr<SemanticAction>>, ActionOrder>
-    action_list_t;
+typedef ActionWindow action_list_t;
 
 struct MSHR {
   PhysicalMemoryAddress thePaddr;
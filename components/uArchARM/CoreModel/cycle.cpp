@@ -42,6 +42,7 @@
 // LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //  DO-NOT-REMOVE end-copyright-block
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <regex>
@@ -71,56 +72,142 @@ extern uint32_t theInsnCount;
 
 namespace nuArchARM {
 
-bool CoreImpl::checkValidatation() {
-  theFlexusDumpState = dumpState();
-  theQemuDumpState = Flexus::Qemu::Processor::getProcessor(theNode)->dump_state();
-
-  bool ret = (theFlexusDumpState.compare(theQemuDumpState) == 0);
-  if (!ret) {
-
-    // Vector of string to save tokens
-    std::vector<std::string> flex_diff, qemu_diff, diff;
-
-    std::replace(theFlexusDumpState.begin(), theFlexusDumpState.end(), '\n', ' ');
-    std::replace(theQemuDumpState.begin(), theQemuDumpState.end(), '\n', ' ');
-
-    // stringstream class check1
-    std::stringstream flex_check(theFlexusDumpState);
-    std::stringstream qemu_check(theQemuDumpState);
+struct low_doubleword : boost::static_visitor<uint64_t> {
+  uint64_t operator()(int64_t aValue) const {
+    return aValue;
+  }
+  uint64_t operator()(uint64_t aValue) const {
+    return aValue;
+  }
+  uint64_t operator()(bits const &aValue) const {
+    return static_cast<uint64_t>(aValue & bits(0xFFFFFFFFFFFFFFFFULL));
+  }
+};
 
-    std::string iflex, iqemu;
+uint64_t CoreImpl::nextValidation() {
+  if (!theValidateSampled) {
+    return theValidateInterval;
+  }
+  // xorshift64; uniform gaps in [1, 2*interval-1] keep the mean at one interval
+  theValidateSeed ^= theValidateSeed << 13;
+  theValidateSeed ^= theValidateSeed >> 7;
+  theValidateSeed ^= theValidateSeed << 17;
+  return 1 + theValidateSeed % (2 * static_cast<uint64_t>(theValidateInterval) - 1);
+}
 
-    // Tokenizing w.r.t. space ' '
-    while (std::getline(flex_check, iflex, ' ')) {
-      flex_diff.push_back(iflex);
+void CoreImpl::getValidationState(armValidationState &aState) {
+  mapped_reg mreg;
+  if (theValidateState & kValidateGPR) {
+    aState.thePC = theDumpPC;
+    mreg.theType = xRegisters;
+    for (int32_t i = 0; i < 32; ++i) {
+      mreg.theIndex = theMapTables[0]->mapArchitectural(i);
+      aState.theXRegs[i] = boost::apply_visitor(low_doubleword(), theRegisters.peek(mreg));
     }
-    while (std::getline(qemu_check, iqemu, ' ')) {
-      qemu_diff.push_back(iqemu);
+    mreg.theType = ccBits;
+    mreg.theIndex = theMapTables[2]->mapArchitectural(0);
+    uint64_t psr = boost::apply_visitor(low_doubleword(), theRegisters.peek(mreg));
+    aState.theFlags = (psr & PSTATE_NZCV) | (_PSTATE().EL() << 2);
+  }
+  if (theValidateState & kValidateSIMD) {
+    mreg.theType = vRegisters;
+    for (int32_t i = 0; i < 32; ++i) {
+      mreg.theIndex = theMapTables[1]->mapArchitectural(i);
+      aState.theVRegs[i] = boost::apply_visitor(low_doubleword(), theRegisters.peek(mreg));
     }
-
-    for (size_t i = 0; i < flex_diff.size() && i < qemu_diff.size(); i++) {
-      if (flex_diff[i].compare(qemu_diff[i]) != 0) {
-        diff.push_back("flexus: " + flex_diff[i]);
-        diff.push_back("qemu:   " + qemu_diff[i]);
-      }
+  }
+  if (theValidateState & kValidateFP) {
+    aState.theFPCR = getFPCR();
+    aState.theFPSR = getFPSR();
+  }
+  if (theValidateState & kValidateSP_el) {
+    for (uint8_t i = 0; i < 4; ++i) {
+      aState.theSP_el[i] = getSP_el(i);
+    }
+  }
+  if (theValidateState & kValidateSystem) {
+    for (uint8_t i = 0; i < 4; ++i) {
+      aState.theSCTLR[i] = getSCTLR_EL(i);
     }
+    aState.theHCR_EL2 = getHCREL2();
+  }
+}
 
-    if (diff.size() > 0) {
-      DBG_(Dev, (<< "state mismatch: "));
-      for (auto &i : diff) {
-        DBG_(Dev, (<< i));
-      }
+void CoreImpl::readValidationState(armValidationState &aState) {
+  Flexus::Qemu::Processor cpu = Flexus::Qemu::Processor::getProcessor(theNode);
+  if (theValidateState & kValidateGPR) {
+    aState.thePC = cpu->readPC();
+    for (int32_t i = 0; i < 32; ++i) {
+      aState.theXRegs[i] = cpu->readXRegister(i);
+    }
+    aState.theFlags = cpu->readPSTATE() & (PSTATE_NZCV | PSTATE_EL);
+  }
+  if (theValidateState & kValidateSIMD) {
+    for (int32_t i = 0; i < 32; ++i) {
+      aState.theVRegs[i] = cpu->readVRegister(i);
+    }
+  }
+  if (theValidateState & kValidateFP) {
+    aState.theFPCR = cpu->readFPCR();
+    aState.theFPSR = cpu->readFPSR();
+  }
+  if (theValidateState & kValidateSP_el) {
+    for (uint8_t i = 0; i < 4; ++i) {
+      aState.theSP_el[i] = cpu->readSP_el(i);
+    }
+  }
+  if (theValidateState & kValidateSystem) {
+    for (uint8_t i = 0; i < 4; ++i) {
+      aState.theSCTLR[i] = cpu->readSCTLR(i);
     }
+    aState.theHCR_EL2 = cpu->readHCREL2();
   }
+}
 
-  return ret;
+void CoreImpl::diffValidationState(armValidationState const &aFlexus,
+                                   armValidationState const &aQemu) {
+  DBG_(Dev, (<< theName << " state mismatch at PC " << std::hex << aQemu.thePC << std::dec));
+  auto diff = [](std::string const &aName, uint64_t aFlexusValue, uint64_t aQemuValue) {
+    DBG_(Dev, Condition(aFlexusValue != aQemuValue)(<< "  " << aName << " flexus: " << std::hex
+                                                     << aFlexusValue << " qemu: " << aQemuValue
+                                                     << std::dec));
+  };
+  diff("PC", aFlexus.thePC, aQemu.thePC);
+  for (int32_t i = 0; i < 32; ++i) {
+    diff(i == 31 ? std::string("SP") : "X" + std::to_string(i), aFlexus.theXRegs[i],
+         aQemu.theXRegs[i]);
+  }
+  for (int32_t i = 0; i < 32; ++i) {
+    diff("V" + std::to_string(i), aFlexus.theVRegs[i], aQemu.theVRegs[i]);
+  }
+  for (int32_t i = 0; i < 4; ++i) {
+    diff("SP_EL" + std::to_string(i), aFlexus.theSP_el[i], aQemu.theSP_el[i]);
+    diff("SCTLR_EL" + std::to_string(i), aFlexus.theSCTLR[i], aQemu.theSCTLR[i]);
+  }
+  diff("HCR_EL2", aFlexus.theHCR_EL2, aQemu.theHCR_EL2);
+  diff("NZCV/EL", aFlexus.theFlags, aQemu.theFlags);
+  diff("FPCR", aFlexus.theFPCR, aQemu.theFPCR);
+  diff("FPSR", aFlexus.theFPSR, aQemu.theFPSR);
+}
+
+bool CoreImpl::checkValidatation() {
+  armValidationState flexus = {}, qemu = {};
+  getValidationState(flexus);
+  readValidationState(qemu);
+
+  if (std::memcmp(&flexus, &qemu, sizeof(armValidationState)) == 0) {
+    return true;
+  }
+  diffValidationState(flexus, qemu);
+  return false;
 }
 
 void CoreImpl::cycle(eExceptionType aPendingInterrupt) {
 
   // qemu warmup
   if (theFlexus->cycleCount() == 1) {
-    advance_fn();
+    int32_t executed;
+    advance_fn(1, executed);
     throw ResynchronizeWithQemuException();
   }
 
@@ -331,7 +418,7 @@ void CoreImpl::cycle(eExceptionType aPendingInterrupt) {
 
   rob_t::iterator i;
   for (i = theROB.begin(); i != theROB.end(); ++i) {
-    i->get()->decrementCanRetireCounter();
+    i->get()->decrementCanRetireCounter(1);
   }
 
   CORE_DBG("--------------FINISH CORE------------------------");
@@ -351,10 +438,13 @@ void CoreImpl::evaluate() {
   FLEXUS_PROFILE();
   CORE_DBG("--------------START EVALUATING------------------------");
 
-  while (!theActiveActions.empty()) {
-    theActiveActions.top()->evaluate();
-    theActiveActions.pop();
+  // Actions scheduled while evaluating land in theRescheduledActions, so the
+  // active window is stable for the whole walk.
+  theActiveActions.order();
+  for (auto &entry : theActiveActions) {
+    entry.second->evaluate();
   }
+  theActiveActions.clear();
   CORE_DBG("--------------FINISH EVALUATING------------------------");
 }
 
@@ -369,22 +459,6 @@ void CoreImpl::satisfy(InstructionDependance const &aDep) {
 void CoreImpl::squash(InstructionDependance const &aDep) {
   aDep.squash();
 }
-void CoreImpl::satisfy(std::list<InstructionDependance> &dependances) {
-  std::list<InstructionDependance>::iterator iter = dependances.begin();
-  std::list<InstructionDependance>::iterator end = dependances.end();
-  while (iter != end) {
-    iter->satisfy();
-    ++iter;
-  }
-}
-void CoreImpl::squash(std::list<InstructionDependance> &dependances) {
-  std::list<InstructionDependance>::iterator iter = dependances.begin();
-  std::list<InstructionDependance>::iterator end = dependances.end();
-  while (iter != end) {
-    iter->squash();
-    ++iter;
-  }
-}
 
 void CoreImpl::spinDetect(memq_t::index<by_insn>::type::iterator iter) {
   if (theSpinning) {
@@ -1288,14 +1362,13 @@ void CoreImpl::doAbortSpeculation() {
 
   // Ensure that the violating instruction is in the SRB.
   DBG_Assert(!theSRB.empty());
-  rob_t::index<by_insn>::type::iterator iter = theSRB.get<by_insn>().find(theViolatingInstruction);
-  if (iter == theSRB.get<by_insn>().end()) {
+  rob_t::iterator srb_iter = theSRB.find(theViolatingInstruction);
+  if (srb_iter == theSRB.end()) {
     DBG_Assert(false, (<< " Violating instruction is not in SRB: " << *theViolatingInstruction));
   }
 
   // Locate the instruction that caused the violation and the nearest
   // preceding checkpoint
-  rob_t::iterator srb_iter = theSRB.project<0>(iter);
   rob_t::iterator srb_begin = theSRB.begin();
   rob_t::iterator srb_ckpt = srb_begin;
   int32_t saved_discard_count = 0;
@@ -1474,6 +1547,11 @@ void CoreImpl::commit() {
 
   while (!theSRB.empty() && (theSRB.front()->mayCommit() || theSRB.front()->isSquashed())) {
 
+    // QEMU must catch up before an unbatched instruction applies its commit effects
+    if (!mayBatchAdvance(theSRB.front())) {
+      advanceBatched();
+    }
+
     if (theSRB.front()->hasCheckpoint()) {
       freeCheckpoint(theSRB.front());
     }
@@ -1502,6 +1580,76 @@ void CoreImpl::commit() {
 
     theSRB.pop_front();
   }
+  advanceBatched();
+
+  // Retirement updates the architectural register map for every instruction
+  // it moves into the SRB, so the map only matches QEMU once the SRB is empty
+  if (theValidationDue && theSRB.empty()) {
+    theValidationDue = false;
+    if (!checkValidatation()) {
+      theEmptyROBCause = kResync;
+      ++theResync_FailedValidation;
+      throw ResynchronizeWithQemuException();
+    }
+  }
+}
+
+bool CoreImpl::mayBatchAdvance(boost::intrusive_ptr<Instruction> anInstruction) {
+  return theCommitBatch > 1 && anInstruction->advancesSimics() &&
+         anInstruction->willRaise() == kException_None && !anInstruction->willOverrideSimics() &&
+         !anInstruction->resync();
+}
+
+void CoreImpl::advanceBatched() {
+  if (theBatch.empty()) {
+    return;
+  }
+  int32_t count = theBatch.size();
+
+  // QEMU state can only be compared with the core before the first batched
+  // instruction executes and after the last executed one has
+  bool validation_passed = theBatch.front()->preValidate();
+
+  // Only the instructions QEMU executed have committed; the rest are refetched
+  // after the resynchronization below
+  int32_t executed = 0;
+  boost::intrusive_ptr<Instruction> last;
+  int raised = theBatch.drain(
+      [this, &executed](int32_t aCount, int32_t &anExecuted) {
+        int result = advance_fn(aCount, anExecuted);
+        executed = anExecuted;
+        return result;
+      },
+      [this, &last](boost::intrusive_ptr<Instruction> const &anInsn, bool aRaised) {
+        accountCommit(anInsn, aRaised);
+        theDumpPC = anInsn->pcNext();
+        last = anInsn;
+      });
+
+  if (raised != 0) {
+    // Every batched instruction predicted no exception, so QEMU disagrees with
+    // the core somewhere in the batch
+    DBG_(VVerb, (<< theName << " QEMU raised 0x" << std::hex << raised << std::dec
+                 << " at instruction " << executed << " of a batch of " << count));
+    if (raised < 0x400) {
+      ++theResync_UnexpectedException;
+    } else {
+      ++theResync_Interrupt;
+    }
+    theEmptyROBCause = kSync;
+    throw ResynchronizeWithQemuException(true);
+  }
+
+  if (last) {
+    validation_passed &= last->postValidate();
+  }
+  if (!validation_passed) {
+    DBG_(Dev, (<< theName << " Failed Validated batch of " << count << " after " << executed
+                << " instructions"));
+    theEmptyROBCause = kResync;
+    ++theResync_FailedValidation;
+    throw ResynchronizeWithQemuException();
+  }
 }
 
 int s_validation = 0;
@@ -1522,6 +1670,23 @@ void CoreImpl::commit(boost::intrusive_ptr<Instruction> anInstruction) {
   //    }
   //  }
 
+  if (mayBatchAdvance(anInstruction)) {
+    // QEMU executes this instruction with the rest of its batch, and only
+    // reports back if one of them raises.  advanceBatched() accounts it once
+    // QEMU has executed it.
+    theInterruptSignalled = false;
+    theInterruptInstruction = 0;
+    if (theValidateInterval > 0 && --theCommitsToValidation == 0) {
+      theCommitsToValidation = nextValidation();
+      theValidationDue = true;
+    }
+    theBatch.push(anInstruction);
+    if (theBatch.size() == theCommitBatch) {
+      advanceBatched();
+    }
+    return;
+  }
+
   bool validation_passed = true;
 
   int raised = 0;
@@ -1539,7 +1704,8 @@ void CoreImpl::commit(boost::intrusive_ptr<Instruction> anInstruction) {
     theInterruptSignalled = false;
     theInterruptInstruction = 0;
 
-    raised = advance_fn();
+    int32_t executed;
+    raised = advance_fn(1, executed);
 
     if (raised != 0) {
       if (anInstruction->willRaise() !=
@@ -1586,7 +1752,11 @@ void CoreImpl::commit(boost::intrusive_ptr<Instruction> anInstruction) {
     throw ResynchronizeWithQemuException(true);
   }
 
-  // validation_passed &= checkValidatation();
+  if (theValidateInterval > 0 && anInstruction->advancesSimics() &&
+      --theCommitsToValidation == 0) {
+    theCommitsToValidation = nextValidation();
+    theValidationDue = true;
+  }
 
   validation_passed &= anInstruction->postValidate();
   DBG_(Iface, (<< "Post Validating... " << validation_passed));
@@ -1610,7 +1780,7 @@ bool CoreImpl::squashFrom(boost::intrusive_ptr<Instruction> anInsn) {
     theSquashRequested = true;
     theSquashReason = kBranchMispredict;
     theEmptyROBCause = kMispredict;
-    theSquashInstruction = theROB.project<0>(theROB.get<by_insn>().find(anInsn));
+    theSquashInstruction = theROB.find(anInsn);
     theSquashInclusive = true;
     return true;
   }
@@ -1830,6 +2000,24 @@ void CoreImpl::valuePredictAtomic() {
   }
 }
 
+// The core can do nothing until the memory system replies to the access at the
+// head of the ROB.  Two idle cycles in a row mean that what the front end reads
+// from the core has settled too.  Nothing here waits on a cycle count.
+bool CoreImpl::isMemoryStalled() const {
+  if (theIdleCycleCount < 2 || theROB.empty() || !theSRB.empty() || theIsSpeculating ||
+      theTSOBReplayStalls > 0 || thePendingInterrupt != kException_None ||
+      !theActiveActions.empty() || !theRescheduledActions.empty() || !theMemoryReplies.empty() ||
+      !theBranchFeedback.empty() || theSquashRequested || theRedirectRequested ||
+      !theMemoryPortArbiter.empty() || !theMemoryPorts.empty() || !theSnoopPorts.empty() ||
+      !theTranslationQueue.empty()) {
+    return false;
+  }
+  memq_t::index<by_insn>::type::const_iterator iter =
+      theMemQueue.get<by_insn>().find(theROB.front());
+  return iter != theMemQueue.get<by_insn>().end() && iter->status() == kIssuedToMemory &&
+         !iter->isAbnormalAccess();
+}
+
 bool CoreImpl::isIdleLoop() {
   // /   assert(false);
   return false; // ALEX - we don't currently have WhiteBox in QEMU
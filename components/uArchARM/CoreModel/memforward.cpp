@@ -191,24 +191,25 @@ void CoreImpl::forwardValue(MemQueueEntry const &aStore,
   }
 }
 
-template <class Iter>
 boost::optional<memq_t::index<by_insn>::type::iterator>
-CoreImpl::snoopQueue(Iter iter, Iter end, memq_t::index<by_insn>::type::iterator load) {
+CoreImpl::snoopQueue(memq_t::index<by_insn>::type::iterator load) {
   FLEXUS_PROFILE();
-  boost::reverse_iterator<Iter> r_iter(iter);
-  boost::reverse_iterator<Iter> r_end(end);
+  // Walk older entries to the same aligned address, youngest first
+  uint64_t addr = load->thePaddr_aligned;
+  uint32_t first = theMemQueueAddresses.begin();
+  uint32_t slot = theMemQueueAddresses.lowerBound(load->theSequenceNum);
 
-  while (r_iter != r_end) {
+  while ((slot = theMemQueueAddresses.prevMatch(first, slot, addr)) != first) {
+    memq_t::iterator entry = theMemQueueAddresses.entry(--slot);
 
-    DBG_(Verb, (<< theName << " " << *load << " snooping " << *r_iter));
-    if (r_iter->isStore() && (r_iter->status() != kAnnulled) && intersects(*r_iter, *load)) {
-      DBG_Assert(r_iter->theSequenceNum < load->theSequenceNum);
-      DBG_(Verb, (<< theName << " " << *load << " forwarding" << *r_iter));
+    DBG_(Verb, (<< theName << " " << *load << " snooping " << *entry));
+    if (entry->isStore() && (entry->status() != kAnnulled) && intersects(*entry, *load)) {
+      DBG_Assert(entry->theSequenceNum < load->theSequenceNum);
+      DBG_(Verb, (<< theName << " " << *load << " forwarding" << *entry));
       // See if the store covers the entire load
-      forwardValue(*r_iter, load);
-      return theMemQueue.get<by_insn>().find(r_iter->theInstruction);
+      forwardValue(*entry, load);
+      return theMemQueue.project<by_insn>(entry);
     }
-    ++r_iter;
   }
   return theMemQueue.get<by_insn>().end();
 }
@@ -236,10 +237,7 @@ CoreImpl::snoopStores(memq_t::index<by_insn>::type::iterator aLoad,
       forwardValue(**aCachedSnoopState, aLoad);
     }
   } else {
-    memq_t::index<by_paddr>::type::iterator load = theMemQueue.project<by_paddr>(aLoad);
-    memq_t::index<by_paddr>::type::iterator oldest_match =
-        theMemQueue.get<by_paddr>().lower_bound(std::make_tuple(aLoad->thePaddr_aligned));
-    aCachedSnoopState = snoopQueue(load, oldest_match, aLoad);
+    aCachedSnoopState = snoopQueue(aLoad);
   }
 
   return aCachedSnoopState;
@@ -256,76 +254,67 @@ void CoreImpl::updateDependantLoads(memq_t::index<by_insn>::type::iterator anUpd
   DBG_(Verb, (<< "Updating loads dependant on " << *anUpdatedStore));
   CORE_DBG("Updating loads dependant on " << *anUpdatedStore);
 
-  memq_t::index<by_paddr>::type::iterator updated_store =
-      theMemQueue.project<by_paddr>(anUpdatedStore);
-  memq_t::index<by_paddr>::type::iterator iter, entry, last_match;
-  last_match =
-      theMemQueue.get<by_paddr>().upper_bound(std::make_tuple(updated_store->thePaddr_aligned));
+  uint64_t addr = anUpdatedStore->thePaddr_aligned;
+  uint32_t slot = theMemQueueAddresses.lowerBound(anUpdatedStore->theSequenceNum + 1);
 
   // Loads with higher sequence numbers than anUpdatedStore must be squashed and
   // obtain their new value
   boost::optional<memq_t::index<by_insn>::type::iterator> cached_search =
       boost::make_optional(false, memq_t::index<by_insn>::type::iterator());
-  iter = updated_store;
-  ++iter;
-  while (iter != last_match) {
-    entry = iter;
-    ++iter;
-    uint64_t seq_no = iter->theSequenceNum;
-    DBG_Assert(entry->theSequenceNum > updated_store->theSequenceNum,
-               (<< " entry: " << *entry << " updated_store: " << *updated_store));
-    if (entry->isLoad() && intersects(*updated_store, *entry)) {
+  while ((slot = theMemQueueAddresses.nextMatch(slot, theMemQueueAddresses.end(), addr)) !=
+         theMemQueueAddresses.end()) {
+    memq_t::iterator entry = theMemQueueAddresses.entry(slot);
+    uint64_t seq_no = entry->theSequenceNum;
+    DBG_Assert(seq_no > anUpdatedStore->theSequenceNum,
+               (<< " entry: " << *entry << " updated_store: " << *anUpdatedStore));
+    if (entry->isLoad() && intersects(*anUpdatedStore, *entry)) {
       CORE_DBG("Loads of overlapping address must re-snoop");
 
       // Loads of overlapping address must re-snoop
-      bool research = (iter != last_match);
       cached_search = doLoad(theMemQueue.project<by_insn>(entry), cached_search);
-      if (research) {
-        iter = theMemQueue.get<by_paddr>().lower_bound(
-            std::make_tuple(updated_store->thePaddr_aligned, seq_no));
-        last_match = theMemQueue.get<by_paddr>().upper_bound(
-            std::make_tuple(updated_store->thePaddr_aligned));
-      }
+      // doLoad() may have changed theMemQueue, so look up where to resume
+      slot = theMemQueueAddresses.lowerBound(seq_no + 1);
     } else if (entry->isStore() && (entry->status() != kAnnulled) &&
-               intersects(*updated_store, *entry)) {
+               intersects(*anUpdatedStore, *entry)) {
       CORE_DBG("Search terminated at " << *entry);
       DBG_(Verb, (<< "Search terminated at " << *entry));
       break; // Stop on a subsequent store which intersects this store.  Loads
              // past this point will not change outcome as a result of this
              // store
+    } else {
+      ++slot;
     }
   }
   DBG_(Verb, (<< "Search complete."));
   CORE_DBG("Search complete.");
 }
 
-void CoreImpl::applyStores(memq_t::index<by_paddr>::type::iterator aFirstStore,
-                           memq_t::index<by_paddr>::type::iterator aLastStore,
+void CoreImpl::applyStores(uint32_t aFirstSlot, uint32_t aLastSlot,
                            memq_t::index<by_insn>::type::iterator aLoad) {
   FLEXUS_PROFILE();
-  while (aFirstStore != aLastStore) {
+  uint64_t addr = aLoad->thePaddr_aligned;
+  while ((aFirstSlot = theMemQueueAddresses.nextMatch(aFirstSlot, aLastSlot, addr)) != aLastSlot) {
+    memq_t::iterator store = theMemQueueAddresses.entry(aFirstSlot);
     // This optimization is broken if there is a store in the SRB
-    //  if (aFirstStore->theQueue == kSB) {
+    //  if (store->theQueue == kSB) {
     //    DBG_( Verb, ( << theName << " Reached start of SB in applyStores") );
     //    return;
     //  }
-    if (aFirstStore->isStore() && aFirstStore->theValue && (aFirstStore->status() != kAnnulled)) {
-      if (intersects(*aFirstStore, *aLoad)) {
-        DBG_(Verb, (<< theName << " Applying " << *aFirstStore << " to " << *aLoad));
-        overlay(*aFirstStore, *aLoad);
+    if (store->isStore() && store->theValue && (store->status() != kAnnulled)) {
+      if (intersects(*store, *aLoad)) {
+        DBG_(Verb, (<< theName << " Applying " << *store << " to " << *aLoad));
+        overlay(*store, *aLoad);
       }
     }
-    ++aFirstStore;
+    ++aFirstSlot;
   }
 }
 void CoreImpl::applyAllStores(memq_t::index<by_insn>::type::iterator aLoad) {
   FLEXUS_PROFILE();
   DBG_(Verb, (<< theName << " Partial snoop applying stores: " << *aLoad));
   // Need to apply every overlapping store to the value of this load.
-  memq_t::index<by_paddr>::type::iterator load = theMemQueue.project<by_paddr>(aLoad);
-  memq_t::index<by_paddr>::type::iterator oldest_match =
-      theMemQueue.get<by_paddr>().lower_bound(std::make_tuple(aLoad->thePaddr_aligned));
-  applyStores(oldest_match, load, aLoad);
+  applyStores(theMemQueueAddresses.begin(),
+              theMemQueueAddresses.lowerBound(aLoad->theSequenceNum), aLoad);
 
   //  if ((aLoad->theASI == 0x24) || (aLoad->theASI == 0x2C)) {
   //    DBG_( Verb, ( << theName << " Partial snoop applying stores: " <<
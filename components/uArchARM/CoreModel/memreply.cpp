@@ -125,14 +125,15 @@ void CoreImpl::invalidate(PhysicalMemoryAddress anAddress) {
     }
   }
 
-  memq_t::index<by_paddr>::type::iterator start, temp, end;
-
-  start = theMemQueue.get<by_paddr>().lower_bound(std::make_tuple(anAddress));
-  end = theMemQueue.get<by_paddr>().upper_bound(
-      std::make_tuple(PhysicalMemoryAddress(anAddress + static_cast<int>(theCoherenceUnit - 1))));
-  if (start == end) {
+  // (aligned address, sequence number) of every entry within the block, in
+  // address order
+  std::vector<std::pair<uint64_t, uint64_t>> matches;
+  theMemQueueAddresses.collect(anAddress, anAddress + static_cast<int>(theCoherenceUnit - 1),
+                               matches);
+  if (matches.empty()) {
     return; // No matches for this physical memory address
   }
+  std::sort(matches.begin(), matches.end());
 
   // Loads which meet ALL the following conditions must be squashed:
   //(1):      it is complete (i.e. has produced a value)
@@ -194,9 +195,14 @@ void CoreImpl::invalidate(PhysicalMemoryAddress anAddress) {
 
   bool race_counted = false;
   // Step 2 iteratore over all the matching physical addresses.
-  while (start != end) {
-    temp = start;
-    ++start;
+  for (auto const &match : matches) {
+    // Earlier iterations may have re-executed loads; skip entries that have
+    // since left the queue or moved to another address
+    boost::optional<memq_t::iterator> found = theMemQueueAddresses.find(match.second);
+    if (!found || (*found)->thePaddr_aligned != match.first) {
+      continue;
+    }
+    memq_t::iterator temp = *found;
     DBG_(Verb, (<< "Invalidate examining: " << *temp));
 
     // We only care about operations with load semantics that have already
@@ -215,20 +221,7 @@ void CoreImpl::invalidate(PhysicalMemoryAddress anAddress) {
       // it must be squashed.  Otherwise, it overrides Simics.
       if (first_incomplete && temp->theSequenceNum >= *first_incomplete) {
         // Load must be squashed and re-executed
-        int32_t seq_num = 0;
-        PhysicalMemoryAddress addr;
-        bool research = false;
-        if (start != end) {
-          research = true;
-          seq_num = start->theSequenceNum;
-          addr = start->thePaddr_aligned;
-        }
         doLoad(theMemQueue.project<by_insn>(temp), boost::none);
-        if (research) {
-          start = theMemQueue.get<by_paddr>().lower_bound(std::make_tuple(addr, seq_num));
-          end = theMemQueue.get<by_paddr>().upper_bound(std::make_tuple(
-              PhysicalMemoryAddress(anAddress + static_cast<int>(theCoherenceUnit - 1))));
-        }
 
         // Record invalidate replays
         if (!temp->status() == kComplete) {
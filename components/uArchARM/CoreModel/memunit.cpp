@@ -158,8 +158,12 @@ void CoreImpl::insertLSQ(boost::intrusive_ptr<Instruction> anInsn, eOperation an
                          eSize aSize, bool aBypassSB, InstructionDependance const &aDependance,
                          eAccType type) {
   FLEXUS_PROFILE();
-  theMemQueue.push_back(MemQueueEntry(anInsn, ++theMemorySequenceNum, anOperation, aSize,
-                                      aBypassSB && theNAWBypassSB, aDependance));
+  std::pair<memq_t::iterator, bool> inserted =
+      theMemQueue.push_back(MemQueueEntry(anInsn, ++theMemorySequenceNum, anOperation, aSize,
+                                          aBypassSB && theNAWBypassSB, aDependance));
+  if (inserted.second) {
+    theMemQueueAddresses.push_back(inserted.first);
+  }
   DBG_(Verb, (<< "Pushed LSQEntry: " << theMemQueue.back()));
   ++theLSQCount;
   //  DBG_Assert( theLSQCount + theSBCount + theSBNAWCount ==
@@ -169,8 +173,12 @@ void CoreImpl::insertLSQ(boost::intrusive_ptr<Instruction> anInsn, eOperation an
 void CoreImpl::insertLSQ(boost::intrusive_ptr<Instruction> anInsn, eOperation anOperation,
                          eSize aSize, bool aBypassSB, eAccType type) {
   FLEXUS_PROFILE();
-  theMemQueue.push_back(MemQueueEntry(anInsn, ++theMemorySequenceNum, anOperation, aSize,
-                                      aBypassSB && theNAWBypassSB));
+  std::pair<memq_t::iterator, bool> inserted =
+      theMemQueue.push_back(MemQueueEntry(anInsn, ++theMemorySequenceNum, anOperation, aSize,
+                                          aBypassSB && theNAWBypassSB));
+  if (inserted.second) {
+    theMemQueueAddresses.push_back(inserted.first);
+  }
   DBG_(VVerb, (<< "Pushed LSQEntry: " << theMemQueue.back()));
   ++theLSQCount;
   //  DBG_Assert( theLSQCount + theSBCount + theSBNAWCount ==
@@ -297,6 +305,7 @@ void CoreImpl::eraseLSQ(boost::intrusive_ptr<Instruction> anInsn) {
   // Kill off any pending prefetch request
   killStorePrefetches(iter->theInstruction);
 
+  theMemQueueAddresses.erase(iter->theSequenceNum);
   theMemQueue.get<by_insn>().erase(iter);
   DBG_Assert(theLSQCount + theSBCount + theSBNAWCount == static_cast<long>(theMemQueue.size()));
 }
@@ -392,9 +401,17 @@ void CoreImpl::cleanMSHRS(uint64_t aDiscardAfterSequenceNum) {
   }
 }
 
+void CoreImpl::eraseMemQueue(memq_t::index<by_queue>::type::iterator aFirst,
+                             memq_t::index<by_queue>::type::iterator aLast) {
+  for (memq_t::index<by_queue>::type::iterator iter = aFirst; iter != aLast; ++iter) {
+    theMemQueueAddresses.erase(iter->theSequenceNum);
+  }
+  theMemQueue.get<by_queue>().erase(aFirst, aLast);
+}
+
 void CoreImpl::clearLSQ() {
-  theMemQueue.get<by_queue>().erase(theMemQueue.get<by_queue>().lower_bound(std::make_tuple(kLSQ)),
-                                    theMemQueue.get<by_queue>().upper_bound(std::make_tuple(kLSQ)));
+  eraseMemQueue(theMemQueue.get<by_queue>().lower_bound(std::make_tuple(kLSQ)),
+                theMemQueue.get<by_queue>().upper_bound(std::make_tuple(kLSQ)));
   theLSQCount = 0;
   DBG_Assert(theLSQCount + theSBCount + theSBNAWCount == static_cast<long>(theMemQueue.size()));
 }
@@ -423,7 +440,7 @@ void CoreImpl::clearSSB() {
     theTimeBreakdown.commitAccumulatedStoreCycles(nXactTimeBreakdown::kStore_BufferFull_Other);
   }
 
-  theMemQueue.get<by_queue>().erase(lb, ub);
+  eraseMemQueue(lb, ub);
   theSBCount -= sb_count;
   theSBNAWCount -= sbnaw_count;
   DBG_Assert(theSBCount >= 0);
@@ -467,7 +484,7 @@ int32_t CoreImpl::clearSSB(uint64_t aLowestInsnSeq) {
     theTimeBreakdown.commitAccumulatedStoreCycles(nXactTimeBreakdown::kStore_BufferFull_Other);
   }
 
-  theMemQueue.get<by_queue>().erase(lb, ub);
+  eraseMemQueue(lb, ub);
   theSBCount -= sb_count;
   theSBNAWCount -= sbnaw_count;
   DBG_Assert(theSBCount >= 0);
@@ -577,12 +594,8 @@ void CoreImpl::updateVaddr(memq_t::index<by_insn>::type::iterator lsq_entry,
   lsq_entry->theVaddr = anAddr;
   DBG_(VVerb, (<< "in updateVaddr")); // NOOOSHIN
   lsq_entry->thePaddr = PhysicalMemoryAddress(kUnresolved);
-  // theMemQueue.get<by_insn>().modify( lsq_entry, [](auto& x){
-  // x.thePaddr_aligned = PhysicalMemoryAddress(kUnresolved);});//ll::bind(
-  // &MemQueueEntry::thePaddr_aligned, ll::_1 ) =
-  // PhysicalMemoryAddress(kUnresolved));
-  theMemQueue.get<by_insn>().modify(lsq_entry, ll::bind(&MemQueueEntry::thePaddr_aligned, ll::_1) =
-                                                   PhysicalMemoryAddress(kUnresolved));
+  lsq_entry->thePaddr_aligned = PhysicalMemoryAddress(kUnresolved);
+  theMemQueueAddresses.update(lsq_entry->theSequenceNum, lsq_entry->thePaddr_aligned);
 }
 
 void CoreImpl::updatePaddr(memq_t::index<by_insn>::type::iterator lsq_entry,
@@ -602,11 +615,8 @@ void CoreImpl::updatePaddr(memq_t::index<by_insn>::type::iterator lsq_entry,
   }
 
   PhysicalMemoryAddress addr_aligned(lsq_entry->thePaddr & 0xFFFFFFFFFFFFFFF8ULL);
-  // theMemQueue.get<by_insn>().modify( lsq_entry, [&addr_aligned](auto& x){
-  // x.thePaddr_aligned = addr_aligned; });//ll::bind(
-  // &MemQueueEntry::thePaddr_aligned, ll::_1 ) = addr_aligned);
-  theMemQueue.get<by_insn>().modify(lsq_entry, ll::bind(&MemQueueEntry::thePaddr_aligned, ll::_1) =
-                                                   addr_aligned);
+  lsq_entry->thePaddr_aligned = addr_aligned;
+  theMemQueueAddresses.update(lsq_entry->theSequenceNum, addr_aligned);
 
   if (thePrefetchEarly && lsq_entry->isStore() && lsq_entry->thePaddr != kUnresolved &&
       lsq_entry->thePaddr != 0 && !lsq_entry->isAbnormalAccess()) {
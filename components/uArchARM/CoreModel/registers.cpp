@@ -57,8 +57,8 @@ void CoreImpl::bypass(mapped_reg aReg, register_value aValue) {
 }
 
 void CoreImpl::connectBypass(mapped_reg aReg, boost::intrusive_ptr<Instruction> inst,
-                             std::function<bool(register_value)> fn) {
-  theBypassNetwork.connect(aReg, inst, fn);
+                             BypassConsumer *aConsumer) {
+  theBypassNetwork.connect(aReg, inst, aConsumer);
 }
 
 void CoreImpl::mapRegister(mapped_reg aRegister) {
@@ -66,10 +66,9 @@ std::ostream &operator<<(std::ostream &anOstream, PhysicalMap &aMap) {
       anOstream << "\n\t";
   }
   anOstream << "\n\tFree List\n\t";
-  // for(const auto& aFree: theFreeList)
-  //  anOstream << 'p' << aFree << ' ';
-  std::for_each(aMap.theFreeList.begin(), aMap.theFreeList.end(),
-                ll::var(anOstream) << 'p' << ll::_1 << ' ');
+  for (uint32_t i = 0; i < aMap.freeCount(); ++i) {
+    anOstream << 'p' << aMap.freeRegister(i) << ' ';
+  }
   anOstream << std::endl;
   return anOstream;
 }
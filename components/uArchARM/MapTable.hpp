@@ -47,7 +47,6 @@
 #define FLEXUS_uARCHARM_MAPTABLE_HPP_INCLUDED
 
 #include <algorithm>
-#include <list>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
@@ -161,34 +160,55 @@ struct PhysicalMap {
   int32_t theNameCount;
   int32_t theRegisterCount;
   std::vector<pRegister> theMappings;
-  std::list<pRegister> theFreeList;
-  std::vector<std::list<pRegister>> theAssignedRegisters;
+  // Free registers, kept as a ring of theRegisterCount entries
+  std::vector<pRegister> theFreeList;
+  uint32_t theFreeHead;
+  uint32_t theFreeCount;
+  // Registers assigned to each name, oldest (architectural) first, chained
+  // through per-register links so that freeing any of them is O(1)
+  std::vector<int32_t> theOldestAssigned;
+  std::vector<int32_t> theNewestAssigned;
+  std::vector<int32_t> theOlderAssigned;
+  std::vector<int32_t> theYoungerAssigned;
   std::vector<int> theReverseMappings;
 
   PhysicalMap(int32_t aNameCount, int32_t aRegisterCount)
       : theNameCount(aNameCount), theRegisterCount(aRegisterCount) {
     theMappings.resize(aNameCount);
-    theAssignedRegisters.resize(aNameCount);
+    theFreeList.resize(aRegisterCount);
+    theOldestAssigned.resize(aNameCount);
+    theNewestAssigned.resize(aNameCount);
+    theOlderAssigned.resize(aRegisterCount);
+    theYoungerAssigned.resize(aRegisterCount);
     theReverseMappings.resize(aRegisterCount);
     reset();
   }
 
   void reset() {
     std::fill(theReverseMappings.begin(), theReverseMappings.end(), -1);
+    std::fill(theOlderAssigned.begin(), theOlderAssigned.end(), -1);
+    std::fill(theYoungerAssigned.begin(), theYoungerAssigned.end(), -1);
     // Fill in initial mappings
-    std::copy(boost::counting_iterator<int>(0), boost::counting_iterator<int>(theNameCount),
-              theMappings.begin());
     for (int32_t i = 0; i < theNameCount; ++i) {
       theMappings[i] = i;
       theReverseMappings[i] = i;
-      theAssignedRegisters[i].clear();
-      theAssignedRegisters[i].push_back(i);
+      theOldestAssigned[i] = theNewestAssigned[i] = i;
     }
 
     // Fill in initial free list
-    theFreeList.clear();
     std::copy(boost::counting_iterator<int>(theNameCount),
-              boost::counting_iterator<int>(theRegisterCount), std::back_inserter(theFreeList));
+              boost::counting_iterator<int>(theRegisterCount), theFreeList.begin());
+    theFreeHead = 0;
+    theFreeCount = theRegisterCount - theNameCount;
+  }
+
+  uint32_t freeCount() const {
+    return theFreeCount;
+  }
+
+  // The i'th register on the free list, in allocation order
+  pRegister freeRegister(uint32_t i) const {
+    return theFreeList[(theFreeHead + i) % theRegisterCount];
   }
 
   pRegister map(regName aRegisterName) {
@@ -201,22 +221,34 @@ struct PhysicalMap {
   pRegister mapArchitectural(regName aRegisterName) {
     FLEXUS_PROFILE();
     DBG_Assert(
-        aRegisterName < theAssignedRegisters.size(),
-        (<< "Name: " << aRegisterName << " number of names: " << theAssignedRegisters.size()));
-    return theAssignedRegisters[aRegisterName].front();
+        aRegisterName < theOldestAssigned.size(),
+        (<< "Name: " << aRegisterName << " number of names: " << theOldestAssigned.size()));
+    return theOldestAssigned[aRegisterName];
   }
 
   // return value is new pRegister, previous pRegister
   std::pair<pRegister, pRegister> create(regName aRegisterName) {
     FLEXUS_PROFILE();
     DBG_Assert(aRegisterName < theMappings.size());
+    DBG_Assert(theFreeCount > 0, (<< "Out of physical registers for name " << aRegisterName));
     pRegister previous_reg = theMappings[aRegisterName];
-    pRegister new_reg = theFreeList.front();
-    theFreeList.pop_front();
+    pRegister new_reg = theFreeList[theFreeHead];
+    if (++theFreeHead == static_cast<uint32_t>(theRegisterCount)) {
+      theFreeHead = 0;
+    }
+    --theFreeCount;
     theMappings[aRegisterName] = new_reg;
     DISPATCH_DBG("Mapping archReg[" << aRegisterName << "] -> pReg[" << new_reg
                                     << "] - previous pReg[" << previous_reg << "]");
-    theAssignedRegisters[aRegisterName].push_back(new_reg);
+    int32_t newest = theNewestAssigned[aRegisterName];
+    theOlderAssigned[new_reg] = newest;
+    theYoungerAssigned[new_reg] = -1;
+    if (newest < 0) {
+      theOldestAssigned[aRegisterName] = new_reg;
+    } else {
+      theYoungerAssigned[newest] = new_reg;
+    }
+    theNewestAssigned[aRegisterName] = new_reg;
     DBG_Assert(theReverseMappings[new_reg] == -1);
     theReverseMappings[new_reg] = aRegisterName;
     return std::make_pair(new_reg, previous_reg);
@@ -224,25 +256,28 @@ struct PhysicalMap {
 
   void free(pRegister aRegisterName) {
     FLEXUS_PROFILE();
-    theFreeList.push_back(aRegisterName);
-    std::list<pRegister>::iterator iter, end;
+    DBG_Assert(theFreeCount < static_cast<uint32_t>(theRegisterCount));
+    theFreeList[(theFreeHead + theFreeCount) % theRegisterCount] = aRegisterName;
+    ++theFreeCount;
     int32_t arch_name = theReverseMappings[aRegisterName];
-    DBG_Assert(arch_name >= 0 && arch_name < static_cast<int>(theAssignedRegisters.size()));
+    DBG_Assert(arch_name >= 0 && arch_name < static_cast<int>(theOldestAssigned.size()));
     DBG_Assert(theMappings[arch_name] != aRegisterName);
-    DBG_Assert(theAssignedRegisters[arch_name].size());
+    DBG_Assert(theOldestAssigned[arch_name] >= 0);
     theReverseMappings[aRegisterName] = -1;
-    iter = theAssignedRegisters[arch_name].begin();
-    end = theAssignedRegisters[arch_name].end();
-    bool found = false;
-    while (iter != end) {
-      if (*iter == aRegisterName) {
-        theAssignedRegisters[arch_name].erase(iter);
-        found = true;
-        break;
-      }
-      ++iter;
+    int32_t older = theOlderAssigned[aRegisterName];
+    int32_t younger = theYoungerAssigned[aRegisterName];
+    DBG_Assert(older >= 0 || theOldestAssigned[arch_name] == static_cast<int32_t>(aRegisterName));
+    if (older < 0) {
+      theOldestAssigned[arch_name] = younger;
+    } else {
+      theYoungerAssigned[older] = younger;
+    }
+    if (younger < 0) {
+      theNewestAssigned[arch_name] = older;
+    } else {
+      theOlderAssigned[younger] = older;
     }
-    DBG_Assert(found);
+    theOlderAssigned[aRegisterName] = theYoungerAssigned[aRegisterName] = -1;
   }
 
   void restore(regName aRegisterName, pRegister aReg) {
@@ -262,9 +297,9 @@ struct PhysicalMap {
     //  ++registers[aMapping];
     std::for_each(theMappings.begin(), theMappings.end(), ++ll::var(registers)[ll::_1]);
 
-    // for(const auto& aFree: theFreeList)
-    //  ++registers[aFree];
-    std::for_each(theFreeList.begin(), theFreeList.end(), ++ll::var(registers)[ll::_1]);
+    for (uint32_t i = 0; i < theFreeCount; ++i) {
+      ++registers[freeRegister(i)];
+    }
 
     if (std::find_if(registers.begin(),
                      registers.end()
@@ -286,10 +321,9 @@ struct PhysicalMap {
         anOstream << "\n\t";
     }
     anOstream << "\n\tFree List\n\t";
-    // for(const auto& aFree: theFreeList)
-    //  anOstream << 'p' << aFree << ' ';
-    std::for_each(theFreeList.begin(), theFreeList.end(),
-                  ll::var(anOstream) << 'p' << ll::_1 << ' ');
+    for (uint32_t i = 0; i < theFreeCount; ++i) {
+      anOstream << 'p' << freeRegister(i) << ' ';
+    }
     anOstream << std::endl;
   }
 
@@ -301,10 +335,9 @@ struct PhysicalMap {
     }
   }
   void dumpFreeList(std::ostream &anOstream) {
-    // for(const auto& aFree: theFreeList)
-    //  anOstream << 'p' << aFree << ' ';
-    std::for_each(theFreeList.begin(), theFreeList.end(),
-                  ll::var(anOstream) << 'p' << ll::_1 << ' ');
+    for (uint32_t i = 0; i < theFreeCount; ++i) {
+      anOstream << 'p' << freeRegister(i) << ' ';
+    }
     anOstream << std::endl;
   }
   void dumpReverseMappings(std::ostream &anOstream) {
@@ -320,14 +353,10 @@ struct PhysicalMap {
     }
   }
   void dumpAssignments(std::ostream &anOstream) {
-    for (uint32_t i = 0; i < theAssignedRegisters.size(); ++i) {
+    for (uint32_t i = 0; i < theOldestAssigned.size(); ++i) {
       anOstream << "r" << i << ": ";
-      std::list<pRegister>::iterator iter, end;
-      iter = theAssignedRegisters[i].begin();
-      end = theAssignedRegisters[i].end();
-      while (iter != end) {
-        anOstream << "p" << *iter << " ";
-        ++iter;
+      for (int32_t p = theOldestAssigned[i]; p >= 0; p = theYoungerAssigned[p]) {
+        anOstream << "p" << p << " ";
       }
       anOstream << " ";
       if ((i & 7) == 7)
@@ -47,12 +47,12 @@
 #define FLEXUS_uARCH_REGISTERFILE_HPP_INCLUDED
 
 #include <algorithm>
-#include <list>
 #include <vector>
 
 #include <boost/lambda/bind.hpp>
 #include <boost/lambda/lambda.hpp>
 
+#include "ConsumerTable.hpp"
 #include "uArchInterfaces.hpp"
 
 namespace ll = boost::lambda;
@@ -61,11 +61,15 @@ namespace nuArchARM {
 
 class RegisterFile {
 protected:
-  std::vector<std::vector<std::list<InstructionDependance>>> theDependances;
+  std::vector<ConsumerTable<InstructionDependance>> theDependances;
   std::vector<std::vector<eResourceStatus>> theStatus;
   std::vector<std::vector<register_value>> theRegs;
   std::vector<std::vector<int32_t>> theCollectCounts;
 
+  static bool isComplete(InstructionDependance const &aDependance) {
+    return aDependance.instruction->isComplete();
+  }
+
 public:
   void initialize(std::vector<uint32_t> const &aSizes) {
     theDependances.resize(aSizes.size());
@@ -86,9 +90,7 @@ public:
   void reset() {
     FLEXUS_PROFILE();
     for (uint32_t i = 0; i < theDependances.size(); ++i) {
-      for (auto &aDependance : theDependances[i]) {
-        aDependance.clear();
-      }
+      theDependances[i].clear();
       for (auto &aStatus : theStatus[i]) {
         aStatus = kUnmapped;
       }
@@ -103,17 +105,7 @@ public:
     for (uint32_t i = 0; i < theDependances.size(); ++i) {
       for (uint32_t j = 0; j < theDependances[i].size(); ++j) {
         theCollectCounts[i][j] = 10;
-
-        std::list<InstructionDependance>::iterator iter, temp, end;
-        iter = theDependances[i][j].begin();
-        end = theDependances[i][j].end();
-        while (iter != end) {
-          temp = iter;
-          ++iter;
-          if (temp->instruction->isComplete()) {
-            theDependances[i][j].erase(temp);
-          }
-        }
+        theDependances[i].visit(j, isComplete);
       }
     }
   }
@@ -122,35 +114,28 @@ public:
     FLEXUS_PROFILE();
     if (--theCollectCounts[aReg.theType][aReg.theIndex] <= 0) {
       theCollectCounts[aReg.theType][aReg.theIndex] = 10;
-
-      std::list<InstructionDependance>::iterator iter, temp, end;
-      iter = theDependances[aReg.theType][aReg.theIndex].begin();
-      end = theDependances[aReg.theType][aReg.theIndex].end();
-      while (iter != end) {
-        temp = iter;
-        ++iter;
-        if (temp->instruction->isComplete()) {
-          theDependances[aReg.theType][aReg.theIndex].erase(temp);
-        }
-      }
+      theDependances[aReg.theType].visit(aReg.theIndex, isComplete);
     }
   }
   void map(mapped_reg aReg) {
     FLEXUS_PROFILE();
     theStatus[aReg.theType][aReg.theIndex] = kNotReady;
-    DBG_Assert(theDependances[aReg.theType][aReg.theIndex].empty());
+    DBG_Assert(theDependances[aReg.theType].empty(aReg.theIndex));
   }
   void squash(mapped_reg aReg, uArchARM &aCore) {
     FLEXUS_PROFILE();
     if (theStatus[aReg.theType][aReg.theIndex] != kUnmapped) {
       theStatus[aReg.theType][aReg.theIndex] = kNotReady;
     }
-    aCore.squash(theDependances[aReg.theType][aReg.theIndex]);
+    theDependances[aReg.theType].visit(aReg.theIndex, [](InstructionDependance const &aDep) {
+      aDep.squash();
+      return false;
+    });
   }
   void unmap(mapped_reg aReg) {
     FLEXUS_PROFILE();
     theStatus[aReg.theType][aReg.theIndex] = kUnmapped;
-    theDependances[aReg.theType][aReg.theIndex].clear();
+    theDependances[aReg.theType].clear(aReg.theIndex);
   }
   eResourceStatus status(mapped_reg aReg) {
     return theStatus[aReg.theType][aReg.theIndex];
@@ -163,7 +148,7 @@ public:
   eResourceStatus request(mapped_reg aReg, InstructionDependance const &aDependance) {
     FLEXUS_PROFILE();
     collect(aReg);
-    theDependances[aReg.theType][aReg.theIndex].push_back(aDependance);
+    theDependances[aReg.theType].push(aReg.theIndex, aDependance);
     return theStatus[aReg.theType][aReg.theIndex];
   }
 
@@ -194,20 +179,13 @@ public:
     poke(aReg, aValue, isW);
     theStatus[aReg.theType][aReg.theIndex] = kReady;
 
-    std::list<InstructionDependance>::iterator iter =
-        theDependances[aReg.theType][aReg.theIndex].begin();
-    std::list<InstructionDependance>::iterator end =
-        theDependances[aReg.theType][aReg.theIndex].end();
-    std::list<InstructionDependance>::iterator tmp;
-    while (iter != end) {
-      tmp = iter;
-      ++iter;
-      if (tmp->instruction->isComplete()) {
-        theDependances[aReg.theType][aReg.theIndex].erase(tmp);
-      } else {
-        tmp->satisfy();
+    theDependances[aReg.theType].visit(aReg.theIndex, [](InstructionDependance const &aDep) {
+      if (aDep.instruction->isComplete()) {
+        return true;
       }
-    }
+      aDep.satisfy();
+      return false;
+    });
   }
 };
 
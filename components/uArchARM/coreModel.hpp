@@ -64,12 +64,37 @@ struct armState {
   uint32_t theFPCR;
   uint32_t thePSTATE;
 };
+
+// Groups of architectural state compared against QEMU by checkValidatation()
+enum eValidateState {
+  kValidateGPR = 0x01,   // PC, X0-X30, SP, NZCV and EL
+  kValidateSIMD = 0x02,  // low doubleword of V0-V31
+  kValidateFP = 0x04,    // FPCR and FPSR
+  kValidateSP_el = 0x08, // banked SP_EL0-3
+  kValidateSystem = 0x10 // SCTLR_EL0-3 and HCR_EL2
+};
+
+// Fixed-layout snapshot compared with memcmp; groups not being validated
+// stay zero on both sides
+struct armValidationState {
+  uint64_t thePC;
+  uint64_t theXRegs[32];
+  uint64_t theVRegs[32];
+  uint64_t theSP_el[4];
+  uint64_t theSCTLR[4];
+  uint64_t theHCR_EL2;
+  uint32_t theFlags; // NZCV and EL, in their PSTATE positions
+  uint32_t theFPCR;
+  uint32_t theFPSR;
+  uint32_t theUnused;
+};
+
 struct CoreModel : public uArchARM {
   static CoreModel *construct(uArchOptions_t options
                               // Msutherl, removed
                               //, std::function< void (Flexus::Qemu::Translation &) > translate
                               ,
-                              std::function<int()> advance,
+                              std::function<int(int32_t, int32_t &)> advance,
                               std::function<void(eSquashCause)> squash,
                               std::function<void(VirtualMemoryAddress)> redirect,
                               std::function<void(int, int)> change_mode,
@@ -100,6 +125,9 @@ struct CoreModel : public uArchARM {
   virtual void dispatch(boost::intrusive_ptr<Instruction>) = 0;
 
   virtual void skipCycle() = 0;
+  virtual void accountDormancy() = 0;
+  virtual bool isMemoryStalled() const = 0;
+  virtual void accountStalledCycles(uint64_t aCycles) = 0;
   virtual void cycle(eExceptionType aPendingInterrupt) = 0;
   virtual void issueMMU(TranslationPtr aTranslation) = 0;
 
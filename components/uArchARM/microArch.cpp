@@ -43,6 +43,7 @@
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //  DO-NOT-REMOVE end-copyright-block
 
+#include <algorithm>
 #include <chrono>
 #include <core/boost_extensions/intrusive_ptr.hpp>
 #include <core/types.hpp>
@@ -60,6 +61,7 @@
 namespace ll = boost::lambda;
 #include <components/uArchARM/uArchInterfaces.hpp>
 #include <core/debug/debug.hpp>
+#include <core/dormancy.hpp>
 #include <core/flexus.hpp>
 #include <core/qemu/mai_api.hpp>
 #include <core/stats.hpp>
@@ -98,8 +100,17 @@ class microArchImpl : public microArch {
   Stat::StatCounter theResyncInstructions;
   Stat::StatCounter theOtherResyncs;
   Stat::StatCounter theExceptions;
+  Stat::StatCounter theDormantCycles;
+  Stat::StatCounter theDormantWakeups;
   int32_t theExceptionRaised;
   bool theBreakOnResynchronize;
+  bool theIdleFastForward;
+  bool theDormant;
+  uint32_t theDormantPollInterval;
+  uint64_t theDormantCounted;
+  bool theResyncOnWork;
+  bool theMemoryStalled;
+  uint64_t theStalledAt;
   bool theDriveClients;
   Flexus::Qemu::Processor theClientCPUs[MAX_CLIENT_SIZE];
   int32_t theNumClients;
@@ -124,14 +135,19 @@ public:
         theCore(CoreModel::construct(options
                                      //, ll::bind( &microArchImpl::translate, this, ll::_1)
                                      ,
-                                     ll::bind(&microArchImpl::advance, this), _squash, _redirect,
-                                     _changeState, _feedback, _signalStoreForwardingHit,
-                                     _mmuResync)),
+                                     ll::bind(&microArchImpl::advance, this, ll::_1, ll::_2),
+                                     _squash, _redirect, _changeState, _feedback,
+                                     _signalStoreForwardingHit, _mmuResync)),
         theAvailableROB(0), theResynchronizations(options.name + "-ResyncsCaught"),
         theResyncInstructions(options.name + "-ResyncsCaught:Instruction"),
         theOtherResyncs(options.name + "-ResyncsCaught:Other"),
-        theExceptions(options.name + "-ResyncsCaught:Exception"), theExceptionRaised(0),
-        theBreakOnResynchronize(options.breakOnResynchronize), theDriveClients(false),
+        theExceptions(options.name + "-ResyncsCaught:Exception"),
+        theDormantCycles(options.name + "-Dormant:Cycles"),
+        theDormantWakeups(options.name + "-Dormant:Wakeups"), theExceptionRaised(0),
+        theBreakOnResynchronize(options.breakOnResynchronize),
+        theIdleFastForward(options.idleFastForward), theDormant(false),
+        theDormantPollInterval(options.dormantPollInterval), theDormantCounted(0),
+        theResyncOnWork(false), theMemoryStalled(false), theStalledAt(0), theDriveClients(false),
         theNumClients(0), theNode(options.node), squash(_squash), redirect(_redirect),
         changeState(_changeState), feedback(_feedback),
         signalStoreForwardingHit(_signalStoreForwardingHit), mmuResync(_mmuResync)
@@ -154,6 +170,10 @@ public:
     if (theBreakOnResynchronize && (theNode == 0)) {
       DBG_(Crit, (<< "Simulation will stop on unexpected synchronizations"));
     }
+
+    if (theIdleFastForward) {
+      Flexus::Core::CoreDormancy::dormancy().track(theNode);
+    }
   }
 
   void setupDriveClients() {
@@ -175,14 +195,16 @@ public:
   void driveClients() {
     CORE_DBG(theName << " Driving " << theNumClients << " client CPUs at IPC: " << kClientIPC);
     for (int32_t i = 0; i < theNumClients; ++i) {
-      for (int32_t ipc = 0; ipc < kClientIPC; ++ipc) {
-        theClientCPUs[i]->advance();
+      // Exceptions do not stop a client, so keep going until it has executed kClientIPC
+      for (int32_t executed = 0, step = 0; executed < kClientIPC; executed += step) {
+        theClientCPUs[i]->advance(kClientIPC - executed, step);
       }
     }
   }
 
   void dispatch(boost::intrusive_ptr<AbstractInstruction> anInstruction) {
     FLEXUS_PROFILE();
+    theMemoryStalled = false;
     try {
       boost::intrusive_ptr<Instruction> insn =
           boost::polymorphic_pointer_downcast<Instruction>(anInstruction);
@@ -198,6 +220,10 @@ public:
 
   void pushMemOp(boost::intrusive_ptr<MemOp> op) {
     FLEXUS_PROFILE();
+    theMemoryStalled = false;
+    if (theDormant) {
+      wake(false);
+    }
     if (op->theOperation == kLoadReply || op->theOperation == kAtomicPreloadReply) {
       //      if (op->theSideEffect || op->thePAddr > 0x40000000000LL) {
       //        //Need to get load value from simics
@@ -252,6 +278,7 @@ public:
   }
 
   void pushTranslation(TranslationPtr aTranslation) {
+    theMemoryStalled = false;
     return theCore->pushTranslation(aTranslation);
   }
 
@@ -287,6 +314,19 @@ public:
     return theCore->isQuiesced();
   }
 
+  uint64_t nextEventCycle() {
+    if (!theDormant) {
+      // A core stalled on memory next has work when the reply is pushed to it
+      return theMemoryStalled ? UINT64_MAX : 0;
+    }
+    // A dormant core next has work when QEMU's next timer fires on it
+    uint64_t wait = theCPU->timerDeadline();
+    if (wait == UINT64_MAX) {
+      wait = theDormantPollInterval;
+    }
+    return theDormantCounted + std::max<uint64_t>(wait, 1);
+  }
+
   bool isStalled() {
     return theCore->isStalled();
   }
@@ -296,6 +336,10 @@ public:
   }
 
   void writePermissionLost(PhysicalMemoryAddress anAddress) {
+    theMemoryStalled = false;
+    if (theDormant) {
+      wake(false);
+    }
     theCore->loseWritePermission(eLosePerm_Replacement, anAddress);
   }
 
@@ -316,6 +360,7 @@ public:
   }
 
   virtual void issueMMU(TranslationPtr aTranslation) {
+    theMemoryStalled = false;
     theCore->issueMMU(aTranslation);
   }
 
@@ -333,6 +378,24 @@ public:
     //    if (theDriveClients) {
     //      driveClients();
     //    }
+    // Cycles skipped since the core stalled on memory are accounted here, even
+    // if the reply that ends the stall has already been pushed
+    uint64_t now = Flexus::Core::theFlexus->cycleCount();
+    if (theStalledAt != 0 && now > theStalledAt + 1) {
+      theCore->accountStalledCycles(now - theStalledAt - 1);
+    }
+    theStalledAt = 0;
+
+    if (theDormant) {
+      if (!catchUpQemu(Flexus::Core::theFlexus->cycleCount())) {
+        return;
+      }
+      wake(true);
+    } else if (theResyncOnWork && cpuHasWork()) {
+      // Woken by the memory system, and QEMU has since moved on
+      resynchronize();
+    }
+
     try {
 
       // Record free ROB space for next cycle
@@ -376,6 +439,14 @@ public:
       theExceptionRaised = 0;
     }
 
+    if (theIdleFastForward && theCore->isQuiesced() && !cpuHasWork()) {
+      sleep();
+    }
+    theMemoryStalled = !theDormant && !theResyncOnWork && theCore->isMemoryStalled();
+    if (theMemoryStalled) {
+      theStalledAt = Flexus::Core::theFlexus->cycleCount();
+    }
+
     CORE_DBG("--------------FINISH MICROARCH------------------------");
   }
 
@@ -390,10 +461,64 @@ public:
   //  }
 
 private:
+  bool cpuHasWork() {
+    return theCPU->hasWork() || theCPU->getPendingInterrupt() != 0;
+  }
+
+  // An idle core with nothing in flight stops being modelled: its front-end
+  // and core drives are skipped until QEMU has work for it again or the
+  // memory system touches it.
+  void sleep() {
+    DBG_(Verb, (<< theName << " going dormant"));
+    theDormant = true;
+    theDormantCounted = Flexus::Core::theFlexus->cycleCount();
+    Flexus::Core::CoreDormancy::dormancy().sleep(theNode);
+  }
+
+  // QEMU still steps a dormant cpu once per cycle, as it did while the core
+  // was modelled, so that its clock and timers keep moving.  Steps through
+  // aCycle, including cycles skipped while every component was idle, and
+  // returns whether the cpu has work.
+  bool catchUpQemu(uint64_t aCycle) {
+    while (theDormantCounted < aCycle) {
+      int32_t count = std::min<uint64_t>(aCycle - theDormantCounted, INT32_MAX);
+      int32_t executed = 0;
+      int raised = theCPU->advance(count, executed);
+      theFlexus->watchdogReset(theCPU->id());
+      theDormantCycles += executed;
+      theDormantCounted += executed;
+      if (raised != 0) {
+        // An interrupt was taken
+        return true;
+      }
+    }
+    return cpuHasWork();
+  }
+
+  // A core woken by the memory system only handles the message; its pipeline
+  // is restarted once QEMU has work for it
+  void wake(bool aQemuHasWork) {
+    DBG_(Verb, (<< theName << " waking after dormancy"));
+    // Cycles skipped since the last dormant drive were dormant too
+    catchUpQemu(Flexus::Core::theFlexus->cycleCount() - 1);
+    theDormant = false;
+    Flexus::Core::CoreDormancy::dormancy().wake(theNode);
+    ++theDormantWakeups;
+    theCore->accountDormancy();
+    // QEMU may have moved on (e.g. into an interrupt handler) while the core
+    // was not modelled, so restart the pipeline from its current state
+    if (aQemuHasWork) {
+      resynchronize();
+    } else {
+      theResyncOnWork = true;
+    }
+  }
+
   void resynchronize() {
     FLEXUS_PROFILE();
 
     DBG_(Dev, (<< "Resynchronizing..."));
+    theResyncOnWork = false;
 
     // Clear out all state in theCore
     theCore->reset();
@@ -413,10 +538,10 @@ private:
     redirect(redirect_address);
   }
 
-  int32_t advance() {
+  int32_t advance(int32_t aCount, int32_t &anExecuted) {
     CORE_TRACE;
     FLEXUS_PROFILE();
-    theExceptionRaised = theCPU->advance();
+    theExceptionRaised = theCPU->advance(aCount, anExecuted);
     theFlexus->watchdogReset(theCPU->id());
     return theExceptionRaised;
   }
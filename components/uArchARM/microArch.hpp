@@ -76,6 +76,7 @@ struct microArch {
   virtual const uint32_t core() const = 0;
   virtual bool isSynchronized() = 0;
   virtual bool isQuiesced() = 0;
+  virtual uint64_t nextEventCycle() = 0;
   virtual bool isStalled() = 0;
   virtual int32_t iCount() = 0;
   virtual void dispatch(boost::intrusive_ptr<AbstractInstruction>) = 0;
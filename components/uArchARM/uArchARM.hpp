@@ -69,12 +69,18 @@ COMPONENT_PARAMETERS(
   PARAMETER( ConsistencyModel, uint32_t, "Consistency Model", "consistency", 0 /* SC */ )
   PARAMETER( CoherenceUnit, uint32_t, "Coherence Unit", "coherence", 64 )
   PARAMETER( BreakOnResynchronize, bool, "Break on resynchronizer", "break_on_resynch", false )
+  PARAMETER( IdleFastForward, bool, "Stop modelling a core while it is idle with nothing in flight", "idle_fast_forward", false )
+  PARAMETER( DormantPollInterval, uint32_t, "Longest idle skip while a core is dormant and QEMU reports no timer deadline", "dormant_poll_interval", 1000 )
   PARAMETER( SpinControl, bool, "Enable spin control", "spin_control", true )
   PARAMETER( SpeculativeOrder, bool, "Speculate on Memory Order", "spec_order", false )
   PARAMETER( SpeculateOnAtomicValue, bool, "Speculate on the Value of Atomics", "spec_atomic_val", false )
   PARAMETER( SpeculateOnAtomicValuePerfect, bool, "Use perfect atomic value prediction", "spec_atomic_val_perfect", false )
   PARAMETER( SpeculativeCheckpoints, int, "Number of checkpoints allowed.  0 for infinite", "spec_ckpts", 0)
   PARAMETER( CheckpointThreshold, int, "Number of instructions between checkpoints.  0 disables periodic checkpoints", "ckpt_threshold", 0)
+  PARAMETER( CommitBatch, uint32_t, "Most committed instructions QEMU executes in one advance.  Batched instructions skip per-instruction validation", "commit_batch", 1)
+  PARAMETER( ValidateInterval, uint32_t, "Commits between architectural state validations against QEMU.  0 disables validation", "validate_interval", 0)
+  PARAMETER( ValidateSampled, bool, "Validate at randomly sampled commits, on average once per interval", "validate_sampled", false)
+  PARAMETER( ValidateState, uint32_t, "State validated: 1=GPRs/PC/flags 2=SIMD 4=FPCR/FPSR 8=SP_ELx 16=system registers", "validate_state", 1)
   PARAMETER( EarlySGP, bool, "Notify SGP Early", "early_sgp", false )   /* CMU-ONLY */
   PARAMETER( TrackParallelAccesses, bool, "Track which memory accesses can proceed in parallel", "track_parallel", false ) /* CMU-ONLY */
   PARAMETER( InOrderMemory, bool, "Only allow ROB/SB head to issue to memory", "in_order_memory", false )
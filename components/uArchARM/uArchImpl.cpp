@@ -164,6 +164,14 @@ public:
     return !theMicroArch || theMicroArch->isQuiesced();
   }
 
+  uint64_t nextEventCycle() const {
+    // A multithreaded core is scheduled by the MTManager every cycle
+    if (!theMicroArch || cfg.Multithread) {
+      return 0;
+    }
+    return theMicroArch->nextEventCycle();
+  }
+
   void initialize() {
     uArchOptions_t options;
 
@@ -180,12 +188,19 @@ public:
     options.consistencyModel = (nuArchARM::eConsistencyModel)cfg.ConsistencyModel;
     options.coherenceUnit = cfg.CoherenceUnit;
     options.breakOnResynchronize = cfg.BreakOnResynchronize;
+    // A multithreaded core cannot go dormant while one of its threads has work
+    options.idleFastForward = cfg.IdleFastForward && !cfg.Multithread;
+    options.dormantPollInterval = cfg.DormantPollInterval > 0 ? cfg.DormantPollInterval : 1;
     //    options.validateMMU          = cfg.ValidateMMU;
     options.speculativeOrder = cfg.SpeculativeOrder;
     options.speculateOnAtomicValue = cfg.SpeculateOnAtomicValue;
     options.speculateOnAtomicValuePerfect = cfg.SpeculateOnAtomicValuePerfect;
     options.speculativeCheckpoints = cfg.SpeculativeCheckpoints;
     options.checkpointThreshold = cfg.CheckpointThreshold;
+    options.commitBatch = cfg.CommitBatch;
+    options.validateInterval = cfg.ValidateInterval;
+    options.validateSampled = cfg.ValidateSampled;
+    options.validateState = cfg.ValidateState;
     options.earlySGP = cfg.EarlySGP;                           /* CMU-ONLY */
     options.trackParallelAccesses = cfg.TrackParallelAccesses; /* CMU-ONLY */
     options.inOrderMemory = cfg.InOrderMemory;
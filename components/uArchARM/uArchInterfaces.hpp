@@ -537,7 +537,13 @@ struct uArchOptions_t {
   bool speculateOnAtomicValuePerfect;
   int32_t speculativeCheckpoints;
   int32_t checkpointThreshold;
+  uint32_t commitBatch;
+  uint32_t validateInterval;
+  bool validateSampled;
+  uint32_t validateState;
   bool breakOnResynchronize;
+  bool idleFastForward;
+  uint32_t dormantPollInterval;
   bool validateMMU;
   bool earlySGP;              /* CMU-ONLY */
   bool trackParallelAccesses; /* CMU-ONLY */
@@ -650,7 +656,7 @@ struct Instruction : public Flexus::SharedTypes::AbstractInstruction {
   virtual uint64_t retireStallCycles() const = 0;
 
   virtual void setCanRetireCounter(const uint32_t numCycles) = 0;
-  virtual void decrementCanRetireCounter() = 0;
+  virtual void decrementCanRetireCounter(uint32_t aCycles) = 0;
   virtual bool usesIntAlu() const = 0;
   virtual bool usesIntMult() const = 0;
   virtual bool usesIntDiv() const = 0;
@@ -669,10 +675,29 @@ struct Instruction : public Flexus::SharedTypes::AbstractInstruction {
   virtual void setUsesFpSqrt() = 0;
 };
 
+// Receiver of register wakeups.  Consumers are registered as a (sink, operand)
+// pair rather than as bound closures.
+struct DependanceSink {
+  virtual void satisfy(int32_t anArg) = 0;
+  virtual void squash(int32_t anArg) = 0;
+
+protected:
+  virtual ~DependanceSink() {
+  }
+};
+
 struct InstructionDependance {
   boost::intrusive_ptr<Instruction> instruction; // For lifetime control
-  std::function<void()> squash;
-  std::function<void()> satisfy;
+  DependanceSink *target;
+  int32_t arg;
+  InstructionDependance() : target(0), arg(0) {
+  }
+  void satisfy() const {
+    target->satisfy(arg);
+  }
+  void squash() const {
+    target->squash(arg);
+  }
 };
 
 struct Interaction : public boost::counted_base {
@@ -738,6 +763,16 @@ inline mapped_reg ccReg(uint32_t anIndex) {
 
 typedef boost::variant<int64_t, uint64_t, bits> register_value;
 
+// Receiver of bypassed values.  bypass() returns true once the consumer no
+// longer needs to hear about the register.
+struct BypassConsumer {
+  virtual bool bypass(register_value aValue) = 0;
+
+protected:
+  virtual ~BypassConsumer() {
+  }
+};
+
 struct uArchARM {
 
   virtual ~uArchARM() {
@@ -790,12 +825,6 @@ struct uArchARM {
   virtual void squash(InstructionDependance const &aDep) {
     DBG_Assert(false);
   }
-  virtual void satisfy(std::list<InstructionDependance> &dependances) {
-    DBG_Assert(false);
-  }
-  virtual void squash(std::list<InstructionDependance> &dependances) {
-    DBG_Assert(false);
-  }
   virtual void applyToNext(boost::intrusive_ptr<Instruction> anInsn,
                            boost::intrusive_ptr<Interaction> anInteraction) {
     DBG_Assert(false);
@@ -1037,7 +1066,7 @@ struct uArchARM {
     DBG_Assert(false);
   }
   virtual void connectBypass(mapped_reg aReg, boost::intrusive_ptr<Instruction> inst,
-                             std::function<bool(register_value)>) {
+                             BypassConsumer *aConsumer) {
     DBG_Assert(false);
   }
   virtual eConsistencyModel consistencyModel() const {
@@ -48,6 +48,7 @@
 
 #include <boost/none.hpp>
 #include <core/boost_extensions/padded_string_cast.hpp>
+#include <core/dormancy.hpp>
 #include <core/stats.hpp>
 
 #include <components/MTManager/MTManager.hpp>
@@ -278,6 +279,13 @@ class FLEXUS_COMPONENT(uFetch) {
   // Magic for checking TLB walk.
   std::vector<TranslationPtr> TranslationsFromTLB;
 
+  // Nothing can be fetched or sent until something is pushed here; set by a
+  // single-threaded fetch unit only
+  bool theBlocked;
+  // Cycle of the last drive that was blocked on an I-cache miss, so that miss
+  // cycles skipped while blocked are still counted
+  uint64_t theMissBlockedAt;
+
 private:
   // I-Cache manipulation functions
   //=================================================================
@@ -346,6 +354,8 @@ public:
     theCPUState.resize(cfg.Threads);
 
     theMissQueueSize = cfg.MissQueueSize;
+    theBlocked = false;
+    theMissBlockedAt = 0;
   }
 
   void finalize() {
@@ -363,6 +373,15 @@ public:
     return true;
   }
 
+  uint64_t nextEventCycle() const {
+    // Nothing is fetched for a dormant core until it wakes
+    if (cfg.Threads == 1 &&
+        (theBlocked || Flexus::Core::CoreDormancy::dormancy().isDormant(flexusIndex()))) {
+      return UINT64_MAX;
+    }
+    return 0;
+  }
+
   void saveState(std::string const &aDirName) {
     std::string fname(aDirName);
     fname += "/" + boost::padded_string_cast<3, '0'>(flexusIndex()) + "-L1i";
@@ -383,6 +402,7 @@ public:
   //   Msutherl: TLB in-out functions
   FLEXUS_PORT_ALWAYS_AVAILABLE(iTranslationIn);
   void push(interface::iTranslationIn const &, TranslationPtr &retdTranslations) {
+    theBlocked = false;
     for (std::vector<TranslationPtr>::iterator it = TranslationsFromTLB.begin();
          it != TranslationsFromTLB.end(); ++it) {
       if ((*it)->theID == retdTranslations->theID) {
@@ -399,6 +419,7 @@ public:
   FLEXUS_PORT_ARRAY_ALWAYS_AVAILABLE(FetchAddressIn);
   void push(interface::FetchAddressIn const &, index_t anIndex,
             boost::intrusive_ptr<FetchCommand> &aCommand) {
+    theBlocked = false;
     std::copy(aCommand->theFetches.begin(), aCommand->theFetches.end(),
               std::back_inserter(theFAQ[anIndex]));
   }
@@ -412,6 +433,7 @@ public:
   // SquashIn
   FLEXUS_PORT_ARRAY_ALWAYS_AVAILABLE(SquashIn);
   void push(interface::SquashIn const &, index_t anIndex, eSquashCause &aReason) {
+    theBlocked = false;
     DBG_(Iface, Comp(*this)(<< "CPU[" << std::setfill('0') << std::setw(2) << flexusIndex() << "."
                             << anIndex << "] Fetch SQUASH: " << aReason));
     theFAQ[anIndex].clear();
@@ -437,6 +459,7 @@ public:
   // FetchMissIn
   FLEXUS_PORT_ALWAYS_AVAILABLE(FetchMissIn);
   void push(interface::FetchMissIn const &, MemoryTransport &aTransport) {
+    theBlocked = false;
     DBG_(Trace, Comp(*this)(<< "CPU[" << std::setfill('0') << std::setw(2) << flexusIndex()
                             << "] Fetch Miss Reply Received on Port FMI: "
                             << *aTransport[MemoryMessageTag]));
@@ -464,9 +487,24 @@ public:
     int32_t td = 0;
     if (cfg.Threads > 1) {
       td = nMTManager::MTManager::get()->scheduleFThread(flexusIndex());
+    } else if (Flexus::Core::CoreDormancy::dormancy().isDormant(flexusIndex())) {
+      return;
     }
+    uint64_t now = theFlexus->cycleCount();
+    if (theMissBlockedAt != 0 && now > theMissBlockedAt + 1) {
+      theMissCycles += now - theMissBlockedAt - 1;
+    }
+    theMissBlockedAt = 0;
+
     doFetch(td);
     sendMisses();
+
+    if (cfg.Threads == 1) {
+      theBlocked = isBlocked();
+      if (theBlocked && theIcacheMiss[0]) {
+        theMissBlockedAt = now;
+      }
+    }
   }
 
   Qemu::Processor cpu(index_t anIndex) {
@@ -474,6 +512,24 @@ public:
   }
 
 private:
+  // Whether the next doFetch() and sendMisses() would do nothing: they wait for
+  // an I-cache reply, a translation, fetch addresses or FIQ space
+  bool isBlocked() {
+    if (!theMissQueue.empty() || !theSnoopQueue.empty() || !theReplyQueue.empty() ||
+        theFlexus->quiescing()) {
+      return false;
+    }
+    if (!theBundle->theOpcodes.empty() && theBundle->theOpcodes.begin()->theOpcode != 0) {
+      return false;
+    }
+    if (theIcacheMiss[0] || theFAQ[0].empty() || theBundle->theOpcodes.size() >= theMissQueueSize) {
+      return true;
+    }
+    int32_t available_fiq = 0;
+    FLEXUS_CHANNEL_ARRAY(AvailableFIQ, 0) >> available_fiq;
+    return available_fiq == 0;
+  }
+
   void prefetchNext(index_t anIndex) {
 
     // Limit the number of prefetches.  With some backpressure, the number of
@@ -976,6 +1032,7 @@ private:
     return true;
   }
   void push(interface::ResyncIn const &, index_t anIndex, int &aResync) {
+    theBlocked = false;
     TranslationsFromTLB.clear();
     theBundle->clear();
     theBundleCoreID = aResync;
@@ -168,6 +168,12 @@ public:
       return;
     } catch (...) {
     }
+    try {
+      const StatValue_CounterSnapshot &ptr = dynamic_cast<const StatValue_CounterSnapshot &>(aBase);
+      reduceAvg(ptr);
+      return;
+    } catch (...) {
+    }
     try {
       const StatValue_Average &ptr = dynamic_cast<const StatValue_Average &>(aBase);
       reduceAvg(ptr);
@@ -186,6 +192,10 @@ public:
     theTotal += anAverage.theValue;
     ++theCount;
   }
+  void reduceAvg(const StatValue_CounterSnapshot &aCounter) {
+    theTotal += aCounter.asLongLong();
+    ++theCount;
+  }
   void reduceAvg(const StatValue_Average &anAverage) {
     theTotal += anAverage.theTotal;
     theCount += anAverage.theCount;
@@ -271,6 +281,12 @@ public:
       return;
     } catch (...) {
     }
+    try {
+      const StatValue_CounterSnapshot &ptr = dynamic_cast<const StatValue_CounterSnapshot &>(aBase);
+      reduceStdDev(ptr);
+      return;
+    } catch (...) {
+    }
     try {
       const StatValue_Average &ptr = dynamic_cast<const StatValue_Average &>(aBase);
       reduceStdDev(ptr);
@@ -288,6 +304,9 @@ public:
   void reduceStdDev(const StatValue_Counter &aCount) {
     update(aCount.theValue);
   }
+  void reduceStdDev(const StatValue_CounterSnapshot &aCounter) {
+    update(aCounter.asLongLong());
+  }
   void reduceStdDev(const StatValue_Average &anAverage) {
     update(static_cast<double>(anAverage.theTotal) / anAverage.theCount);
   }
@@ -159,6 +159,8 @@ public:
   }
 
   void addToMeasurement(Stat *aStat);
+  void addValue(std::string const &aStat, boost::intrusive_ptr<StatValueBase> aValue);
+  boost::intrusive_ptr<StatValueBase> valueOf(std::string const &aStat);
   void close();
   bool isSimple() {
     return true;
@@ -253,6 +255,113 @@ public:
   void fire();
 };
 
+// Regions are recorded as snapshots of the running totals of all counters at
+// each region boundary, instead of as measurements with their own updaters.
+// A boundary stores only the counters that changed since the previous one, as
+// (column, total) pairs.  The per-region measurements of counter deltas are
+// rebuilt from these rows when they are asked for.  Stats without a running
+// total (maxima, histograms, instance counters, ...) are copied from the "all"
+// measurement at each boundary, again only when they changed, and a rebuilt
+// region reports their values as of its end.
+class RegionSeries {
+  std::string thePrefix;
+  std::vector<std::string> theColumns;
+  // theRowEnds[r] is the end of boundary r in theChangedColumns/Values
+  std::vector<uint64_t> theRowEnds;
+  std::vector<uint32_t> theChangedColumns;
+  std::vector<int64_t> theChangedValues;
+  // The same layout for the stats without a running total
+  std::vector<std::string> theOtherColumns;
+  std::vector<uint64_t> theOtherRowEnds;
+  std::vector<uint32_t> theOtherChangedColumns;
+  std::vector<boost::intrusive_ptr<StatValueBase>> theOtherChangedValues;
+
+  // Only set while the series is being recorded
+  bool theLive;
+  std::vector<int64_t const *> theSources;
+  std::vector<int64_t> theLastValues;
+  SimpleMeasurement *theAll;
+  std::vector<std::string> theOtherLastValues;
+
+private:
+  friend class boost::serialization::access;
+  template <class Archive> void save(Archive &ar, uint32_t version) const {
+    ar &thePrefix;
+    ar &theColumns;
+    ar &theRowEnds;
+    ar &theChangedColumns;
+    ar &theChangedValues;
+    ar &theOtherColumns;
+    ar &theOtherRowEnds;
+    ar &theOtherChangedColumns;
+    ar &theOtherChangedValues;
+    // The open region is closed by a boundary which exists only in the file
+    std::vector<uint32_t> live_columns;
+    std::vector<int64_t> live_values;
+    std::vector<uint32_t> live_other_columns;
+    std::vector<boost::intrusive_ptr<StatValueBase>> live_other_values;
+    std::vector<std::string> last_printed(theOtherLastValues);
+    if (theLive) {
+      changesSince(live_columns, live_values);
+      otherChangesSince(last_printed, live_other_columns, live_other_values);
+    }
+    ar &live_columns;
+    ar &live_values;
+    ar &live_other_columns;
+    ar &live_other_values;
+  }
+  template <class Archive> void load(Archive &ar, uint32_t version) {
+    clear();
+    ar &thePrefix;
+    ar &theColumns;
+    ar &theRowEnds;
+    ar &theChangedColumns;
+    ar &theChangedValues;
+    ar &theOtherColumns;
+    ar &theOtherRowEnds;
+    ar &theOtherChangedColumns;
+    ar &theOtherChangedValues;
+    std::vector<uint32_t> live_columns;
+    std::vector<int64_t> live_values;
+    std::vector<uint32_t> live_other_columns;
+    std::vector<boost::intrusive_ptr<StatValueBase>> live_other_values;
+    ar &live_columns;
+    ar &live_values;
+    ar &live_other_columns;
+    ar &live_other_values;
+    if (!theRowEnds.empty()) {
+      theChangedColumns.insert(theChangedColumns.end(), live_columns.begin(), live_columns.end());
+      theChangedValues.insert(theChangedValues.end(), live_values.begin(), live_values.end());
+      theRowEnds.push_back(theChangedColumns.size());
+      theOtherChangedColumns.insert(theOtherChangedColumns.end(), live_other_columns.begin(),
+                                    live_other_columns.end());
+      theOtherChangedValues.insert(theOtherChangedValues.end(), live_other_values.begin(),
+                                   live_other_values.end());
+      theOtherRowEnds.push_back(theOtherChangedColumns.size());
+    }
+  }
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+  void changesSince(std::vector<uint32_t> &aColumns, std::vector<int64_t> &aValues) const;
+  void otherChangesSince(std::vector<std::string> &aLastValues, std::vector<uint32_t> &aColumns,
+                         std::vector<boost::intrusive_ptr<StatValueBase>> &aValues) const;
+
+public:
+  RegionSeries() : theLive(false), theAll(nullptr) {
+  }
+
+  void clear();
+  void open(std::string const &aPrefix, std::vector<Stat *> const &aStats,
+            SimpleMeasurement *anAll);
+  void addStat(Stat *aStat);
+  void closeRegion();
+
+  uint32_t regions() const;
+  std::string regionName(uint32_t aRegion) const;
+  std::vector<boost::intrusive_ptr<SimpleMeasurement>>
+  materialize(std::set<uint32_t> const &aRegions) const;
+};
+
 } // namespace aux_
 } // namespace Stat
 } // namespace Flexus
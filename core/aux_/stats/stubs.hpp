@@ -180,6 +180,26 @@ public:
   }
 };
 
+// Updater for values that snapshot their stat instead of being updated by it
+// (see StatValue_CounterSnapshot).  It is not part of any updater chain; it
+// only resets the value, and freezes it once the measurement releases it.
+template <class StatValueType> class SnapshotStatUpdater : public StatUpdaterBase {
+  boost::intrusive_ptr<StatValueType> theValue;
+  typename StatValueType::value_type theResetValue;
+
+public:
+  SnapshotStatUpdater(boost::intrusive_ptr<StatValueType> aValue,
+                      typename StatValueType::value_type aResetValue)
+      : theValue(aValue), theResetValue(aResetValue) {
+  }
+  virtual ~SnapshotStatUpdater() {
+    theValue->freeze();
+  }
+  virtual void reset() {
+    theValue->reset(theResetValue);
+  }
+};
+
 } // namespace aux_
 } // namespace Stat
 } // namespace Flexus
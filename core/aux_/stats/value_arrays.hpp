@@ -93,8 +93,9 @@ public:
   }
 
   // Used by serialization of other stat types
-  StatValueArray_Counter(std::vector<simple_type> const &aValueVector, value_type aCurrentValue)
-      : theValues(aValueVector) {
+  StatValueArray_Counter(std::vector<simple_type> const &aValueVector, value_type aCurrentValue,
+                         value_type anInitialValue = 0)
+      : theInitialValue(anInitialValue), theValues(aValueVector) {
     theValues.push_back(simple_type(aCurrentValue));
   }
 
@@ -129,6 +130,73 @@ public:
   }
 };
 
+// Periodic counterpart of StatValue_CounterSnapshot.  Completed periods are
+// stored as plain counters; only the current period tracks the stat.
+class StatValueArray_CounterSnapshot : public StatValueArrayBase {
+public:
+  virtual boost::intrusive_ptr<const StatValueBase> serialForm() const {
+    // Kept alive until the next call, for the same reason as in
+    // StatValue_CounterSnapshot
+    theSerialForm = new StatValueArray_Counter(theValues, theCurrent.value(), theInitialValue);
+    return theSerialForm;
+  };
+
+public:
+  typedef int64_t update_type;
+  typedef int64_t value_type;
+  typedef StatValue_Counter simple_type;
+
+private:
+  value_type theInitialValue;
+  std::vector<simple_type> theValues;
+  StatValue_CounterSnapshot theCurrent;
+  mutable boost::intrusive_ptr<StatValueArray_Counter> theSerialForm;
+
+public:
+  StatValueArray_CounterSnapshot(int64_t const *aSource, value_type aValue)
+      : theInitialValue(aValue), theCurrent(aSource, aValue) {
+  }
+
+  void freeze() {
+    theCurrent.freeze();
+  }
+
+  // Sums period by period with a counter array or another snapshot array
+  void reduceSum(const StatValueBase &aBase) {
+    // operator[] and size() are not const in StatValueArrayBase
+    StatValueArrayBase &rhs =
+        const_cast<StatValueArrayBase &>(dynamic_cast<const StatValueArrayBase &>(aBase));
+    for (std::size_t i = 0; i < size() && i < rhs.size(); ++i) {
+      (*this)[i].reduceSum(rhs[i]);
+    }
+  }
+  void print(std::ostream &anOstream, std::string const &options = std::string("")) const {
+    for (int32_t i = 0; i < static_cast<int>(theValues.size()); ++i) {
+      anOstream << theValues[i] << ", ";
+    }
+    anOstream << theCurrent;
+  }
+  void newValue(accumulation_type aValueType) {
+    theValues.push_back(simple_type(theCurrent.value()));
+    if (aValueType == accumulation_type::Reset) {
+      theCurrent.reset(theInitialValue);
+    }
+  }
+  void reset(value_type aValue) {
+    theValues.clear();
+    theCurrent.reset(aValue);
+  }
+  StatValueBase &operator[](int32_t anIndex) {
+    if (anIndex < static_cast<int>(theValues.size())) {
+      return theValues[anIndex];
+    }
+    return theCurrent;
+  }
+  std::size_t size() {
+    return theValues.size() + 1;
+  }
+};
+
 /*
   class StatValueArray_DoubleCounter : public StatValueArrayBase {
     private:
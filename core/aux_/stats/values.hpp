@@ -96,10 +96,7 @@ public:
   StatValue_Counter(value_type aValue) : theValue(aValue) {
   }
 
-  void reduceSum(StatValueBase const &aBase) {
-    StatValue_Counter const &ctr = dynamic_cast<StatValue_Counter const &>(aBase);
-    reduceSum(ctr);
-  }
+  void reduceSum(StatValueBase const &aBase);
   void reduceSum(StatValue_Counter const &aCounter) {
     theValue += aCounter.theValue;
   }
@@ -124,6 +121,91 @@ public:
   };
 };
 
+// A counter value which is not updated by its stat.  Instead, it remembers the
+// stat's running total when it was (re)started, and computes its value from
+// that snapshot whenever it is read.  When its measurement closes, the value is
+// frozen.  It is always serialized as a plain StatValue_Counter.
+class StatValue_CounterSnapshot : public StatValueBase {
+public:
+  virtual boost::intrusive_ptr<const StatValueBase> serialForm() const {
+    // The serial form is kept alive with this value, so that serialization
+    // object tracking never sees two serial forms at the same address.
+    if (!theSerialForm) {
+      theSerialForm = new StatValue_Counter(value());
+    } else {
+      theSerialForm->reset(value());
+    }
+    return theSerialForm;
+  };
+
+public:
+  typedef int64_t update_type;
+  typedef int64_t value_type;
+
+private:
+  int64_t const *theSource;
+  value_type theBase;
+  value_type theOffset;
+  mutable boost::intrusive_ptr<StatValue_Counter> theSerialForm;
+
+public:
+  StatValue_CounterSnapshot(int64_t const *aSource, value_type aValue)
+      : theSource(aSource), theBase(*aSource), theOffset(aValue) {
+  }
+
+  value_type value() const {
+    if (theSource) {
+      return theOffset + (*theSource - theBase);
+    }
+    return theOffset;
+  }
+  void freeze() {
+    theOffset = value();
+    theSource = 0;
+  }
+
+  void reduceSum(StatValueBase const &aBase) {
+    if (dynamic_cast<StatValue_CounterSnapshot const *>(&aBase)) {
+      theOffset += aBase.asLongLong();
+    } else {
+      theOffset += dynamic_cast<StatValue_Counter const &>(aBase).asLongLong();
+    }
+  }
+  boost::intrusive_ptr<StatValueBase> sumAccumulator() {
+    return new StatValue_Counter(value());
+  }
+  boost::intrusive_ptr<StatValueBase> avgAccumulator() {
+    return StatValue_Counter(value()).avgAccumulator();
+  }
+  boost::intrusive_ptr<StatValueBase> stdevAccumulator() {
+    return StatValue_Counter(value()).stdevAccumulator();
+  }
+
+  void reset(value_type aValue) {
+    theOffset = aValue;
+    if (theSource) {
+      theBase = *theSource;
+    }
+  }
+  void print(std::ostream &anOstream, std::string const &options = std::string("")) const {
+    anOstream << value();
+  }
+  int64_t asLongLong() const {
+    return value();
+  };
+};
+
+inline void StatValue_Counter::reduceSum(StatValueBase const &aBase) {
+  // A snapshot of a counter sums as the counter value it stands for
+  if (StatValue_CounterSnapshot const *snapshot =
+          dynamic_cast<StatValue_CounterSnapshot const *>(&aBase)) {
+    theValue += snapshot->asLongLong();
+    return;
+  }
+  StatValue_Counter const &ctr = dynamic_cast<StatValue_Counter const &>(aBase);
+  reduceSum(ctr);
+}
+
 /*
   class StatValue_DoubleCounter : public StatValueBase {
     private:
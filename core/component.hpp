@@ -57,6 +57,7 @@ namespace ll = boost::lambda;
 
 #include <core/boost_extensions/padded_string_cast.hpp>
 #include <core/component_interface.hpp>
+#include <core/flexpoint.hpp>
 
 #include <core/debug/debugger.hpp>
 
@@ -214,6 +215,23 @@ public:
     // Nothing to save
   }
 
+  virtual bool hasFlexpointSections() const {
+    return false;
+  }
+
+  virtual void saveFlexpoint(FlexpointWriter &aWriter) {
+  }
+
+  virtual bool loadFlexpoint(FlexpointReader const &aReader) {
+    return false;
+  }
+
+  virtual uint64_t nextEventCycle() const {
+    // Components that do not track their pending work must be driven every
+    // cycle.  Returning 0 ("now") disables idle-cycle skipping.
+    return 0;
+  }
+
   FlexusComponentBase(cfg_t &aCfg, typename interface::jump_table &aJumpTable, index_t anIndex,
                       index_t aWidth)
       : FlexusComponent(anIndex, aWidth), cfg(aCfg), jump_table_(aJumpTable) {
@@ -52,6 +52,9 @@
 namespace Flexus {
 namespace Core {
 
+class FlexpointWriter;
+class FlexpointReader;
+
 struct ComponentInterface {
 
   // This allows components to have push output ports
@@ -81,6 +84,17 @@ struct ComponentInterface {
   virtual bool isQuiesced() const = 0;
   virtual void saveState(std::string const &aDirectory) = 0;
   virtual void loadState(std::string const &aDirectory) = 0;
+  // Components that store their state as sections of the unified flexpoint
+  // file return true here.  They are saved and loaded concurrently with each
+  // other, so they must not touch state shared with other components.
+  // loadFlexpoint() returns false if the flexpoint lacks its sections, in
+  // which case the legacy loadState() is used instead.
+  virtual bool hasFlexpointSections() const = 0;
+  virtual void saveFlexpoint(FlexpointWriter &aWriter) = 0;
+  virtual bool loadFlexpoint(FlexpointReader const &aReader) = 0;
+  // Earliest cycle at which any drive of this component may have work to do.
+  // Used by the Drive loop to skip cycles in which every component is idle.
+  virtual uint64_t nextEventCycle() const = 0;
   virtual std::string name() const = 0;
   virtual ~ComponentInterface() {
   }
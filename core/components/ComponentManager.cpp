@@ -44,12 +44,14 @@
 //  DO-NOT-REMOVE end-copyright-block
 #include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include <functional>
 
 #include <core/component.hpp>
 #include <core/debug/debug.hpp>
+#include <core/flexpoint.hpp>
 
 namespace Flexus {
 namespace Wiring {
@@ -137,33 +139,52 @@ public:
   }
 
   void doSave(std::string const &aDirectory) const {
+    std::vector<ComponentInterface *> aSectioned;
     for (auto *aComponent : theComponents) {
-      aComponent->saveState(aDirectory);
+      if (aComponent->hasFlexpointSections()) {
+        aSectioned.push_back(aComponent);
+      } else {
+        aComponent->saveState(aDirectory);
+      }
     }
-    // std::for_each
-    // ( theComponents.begin()
-    //   , theComponents.end()
-    //   , ll::bind( &ComponentInterface::saveState, ll::_1, aDirectory )
-    // );
+    if (aSectioned.empty()) {
+      return;
+    }
+
+    FlexpointWriter aWriter(flexpointFileName(aDirectory));
+    flexpointParallelFor(aSectioned.size(),
+                         [&](size_t i) { aSectioned[i]->saveFlexpoint(aWriter); });
+    aWriter.commit();
   }
 
   void doLoad(std::string const &aDirectory) {
-    std::vector<ComponentInterface *>::iterator iter, end;
-    iter = theComponents.begin();
-    end = theComponents.end();
-    while (iter != end) {
-      DBG_(Dev, (<< "Loading state: " << (*iter)->name()));
-      (*iter)->loadState(aDirectory);
-      ++iter;
+    // Older checkpoints have no flexpoint file, and older flexpoints may lack
+    // a component's sections; those components fall back to loadState().
+    std::unique_ptr<FlexpointReader> aReader = FlexpointReader::open(flexpointFileName(aDirectory));
+    std::vector<ComponentInterface *> aSectioned;
+    if (aReader) {
+      for (auto *aComponent : theComponents) {
+        if (aComponent->hasFlexpointSections()) {
+          aSectioned.push_back(aComponent);
+        }
+      }
+    }
+
+    std::vector<char> aLoaded(aSectioned.size(), false);
+    flexpointParallelFor(aSectioned.size(), [&](size_t i) {
+      aLoaded[i] = aSectioned[i]->loadFlexpoint(*aReader);
+    });
+
+    for (auto *aComponent : theComponents) {
+      auto iter = std::find(aSectioned.begin(), aSectioned.end(), aComponent);
+      if (iter != aSectioned.end() && aLoaded[iter - aSectioned.begin()]) {
+        DBG_(Dev, (<< "Loaded flexpoint sections: " << aComponent->name()));
+        continue;
+      }
+      DBG_(Dev, (<< "Loading state: " << aComponent->name()));
+      aComponent->loadState(aDirectory);
     }
     DBG_(Crit, (<< " Done loading."));
-    /*
-          std::for_each
-            ( theComponents.begin()
-            , theComponents.end()
-            , ll::bind( &ComponentInterface::loadState, ll::_1, aDirectory )
-            );
-    */
   }
 };
 
@@ -46,6 +46,7 @@
 #include <core/debug/debugger.hpp>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <utility>
 
@@ -215,6 +216,13 @@ void Debugger::checkAt() {
   }
 }
 
+int64_t Debugger::nextAt() {
+  if (theAts.empty()) {
+    return std::numeric_limits<int64_t>::max();
+  }
+  return theAts.top().theCycle;
+}
+
 void Debugger::doNextAt() {
   Entry entry = Entry(
       /*Severity*/ Flexus::Dbg::SevCrit, /*File*/ "", /*Line*/ 0,
@@ -125,6 +125,7 @@ public:
   void listComponents(std::ostream &anOstream);
   void addAt(int64_t aCycle, Action *anAction);
   void checkAt();
+  int64_t nextAt();
   void doNextAt();
   void reset();
 
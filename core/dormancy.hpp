@@ -0,0 +1,89 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#ifndef FLEXUS_CORE_DORMANCY_HPP_INCLUDED
+#define FLEXUS_CORE_DORMANCY_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include <core/types.hpp>
+
+namespace Flexus {
+namespace Core {
+
+// Per-core flag marking a core as dormant: idle with nothing in flight, so
+// that the per-core front-end and core drives can skip it entirely.  The core
+// model decides when a core enters and leaves dormancy; the other per-core
+// components only query the flag.  A core's flag is set by its own drive and
+// cleared either by that drive or when the memory system pushes a message to
+// the core.
+class CoreDormancy {
+  std::vector<uint8_t> theDormant;
+
+  CoreDormancy() {
+  }
+
+public:
+  static CoreDormancy &dormancy();
+
+  // Make room for aCore.  Must be called during initialization, before any
+  // drive runs.
+  void track(index_t aCore);
+
+  bool isDormant(index_t aCore) const {
+    return aCore < theDormant.size() && theDormant[aCore];
+  }
+  void sleep(index_t aCore) {
+    theDormant[aCore] = 1;
+  }
+  void wake(index_t aCore) {
+    theDormant[aCore] = 0;
+  }
+};
+
+} // End Namespace Core
+} // namespace Flexus
+
+#endif // FLEXUS_CORE_DORMANCY_HPP_INCLUDED
@@ -81,6 +81,39 @@ template <class DriveHandles> struct do_cycle {
 };
 } // namespace aux_
 
+namespace aux_ {
+template <int32_t N, class DriveHandleIter> struct next_event_step {
+  static uint64_t nextEventCycle(uint64_t aCycle, uint64_t aNextEvent) {
+    for (index_t i = 0; i < mpl::deref<DriveHandleIter>::type::width(); i++) {
+      uint64_t next = mpl::deref<DriveHandleIter>::type::getReference(i).nextEventCycle();
+      if (next < aNextEvent) {
+        aNextEvent = next;
+      }
+      if (aNextEvent <= aCycle + 1) {
+        // Someone has work next cycle, no need to ask the others
+        return aNextEvent;
+      }
+    }
+    return next_event_step<N - 1, typename mpl::next<DriveHandleIter>::type>::nextEventCycle(
+        aCycle, aNextEvent);
+  }
+};
+
+template <class DriveHandleIter> struct next_event_step<0, DriveHandleIter> {
+  static uint64_t nextEventCycle(uint64_t aCycle, uint64_t aNextEvent) {
+    return aNextEvent;
+  }
+};
+
+template <class DriveHandles> struct next_event {
+  static uint64_t nextEventCycle(uint64_t aCycle) {
+    return next_event_step<mpl::size<DriveHandles>::value,
+                           typename mpl::begin<DriveHandles>::type>::nextEventCycle(aCycle,
+                                                                                     UINT64_MAX);
+  }
+};
+} // namespace aux_
+
 namespace aux_ {
 template <int32_t N, class DriveHandleIter> struct list_drives_step {
   static void listDrives() {
@@ -111,6 +144,11 @@ template <class OrderedDriveHandleList> class Drive : public DriveBase {
     FLEXUS_PROFILE_N("Drive::doCycle");
     aux_::do_cycle<OrderedDriveHandleList>::doCycle();
   }
+
+  virtual uint64_t nextEventCycle(uint64_t aCycle) {
+    FLEXUS_PROFILE_N("Drive::nextEventCycle");
+    return aux_::next_event<OrderedDriveHandleList>::nextEventCycle(aCycle);
+  }
 };
 
 } // End Namespace Core
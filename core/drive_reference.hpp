@@ -45,6 +45,8 @@
 #ifndef FLEXUS_DRIVE_REFERENCE_HPP_INCLUDED
 #define FLEXUS_DRIVE_REFERENCE_HPP_INCLUDED
 
+#include <cstdint>
+
 namespace Flexus {
 namespace Core {
 
@@ -52,6 +54,9 @@ struct DriveBase {
   // This method is called every cycle.
   virtual ~DriveBase(){};
   virtual void doCycle() = 0;
+  // Returns the earliest cycle after aCycle at which some drive has work.
+  // Returns a value <= aCycle + 1 as soon as any drive is busy next cycle.
+  virtual uint64_t nextEventCycle(uint64_t aCycle) = 0;
 };
 
 typedef DriveBase &DriveReference;
@@ -0,0 +1,343 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#include <core/debug/debug.hpp>
+#include <core/exception.hpp>
+#include <core/flexpoint.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace Flexus {
+namespace Core {
+
+namespace {
+
+const char kFlexpointMagic[8] = {'F', 'L', 'E', 'X', 'P', 'N', 'T', '1'};
+const uint32_t kFlexpointVersion = 1;
+const uint64_t kFlexpointAlign = 4096;
+
+struct FlexpointHeader {
+  char theMagic[8];
+  uint32_t theVersion;
+  uint32_t theSectionCount;
+  uint64_t theIndexOffset;
+  uint64_t theIndexSize;
+};
+
+uint64_t alignUp(uint64_t anOffset) {
+  return (anOffset + kFlexpointAlign - 1) & ~(kFlexpointAlign - 1);
+}
+
+template <class T> void appendPOD(std::string &aBuffer, T const &aValue) {
+  aBuffer.append(reinterpret_cast<char const *>(&aValue), sizeof(T));
+}
+
+template <class T> bool readPOD(char const *&aCursor, char const *anEnd, T &aValue) {
+  if (anEnd - aCursor < static_cast<ptrdiff_t>(sizeof(T))) {
+    return false;
+  }
+  std::memcpy(&aValue, aCursor, sizeof(T));
+  aCursor += sizeof(T);
+  return true;
+}
+
+void writeAll(int aFd, char const *aData, size_t aSize, std::string const &aFilename) {
+  while (aSize > 0) {
+    ssize_t written = ::write(aFd, aData, aSize);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw FlexusException(__FILE__, __LINE__, "Unable to write flexpoint " + aFilename);
+    }
+    aData += written;
+    aSize -= written;
+  }
+}
+
+} // namespace
+
+std::string flexpointFileName(std::string const &aDirectory) {
+  return aDirectory + "/flexpoint.fxp";
+}
+
+FlexpointWriter::FlexpointWriter(std::string const &aFilename) : theFilename(aFilename) {
+}
+
+void FlexpointWriter::addSection(std::string const &aName, void const *aData, size_t aSize,
+                                 FlexpointCodec aCodec) {
+  Section aSection;
+  aSection.theName = aName;
+  aSection.theCodec = aCodec;
+  aSection.theRawSize = aSize;
+  if (aCodec == kFlexpointZlib) {
+    uLongf aBound = compressBound(aSize);
+    aSection.theData.resize(aBound);
+    if (compress2(reinterpret_cast<Bytef *>(&aSection.theData[0]), &aBound,
+                  reinterpret_cast<Bytef const *>(aData), aSize, Z_BEST_SPEED) != Z_OK) {
+      throw FlexusException(__FILE__, __LINE__, "Unable to compress flexpoint section " + aName);
+    }
+    aSection.theData.resize(aBound);
+  } else {
+    aSection.theData.assign(reinterpret_cast<char const *>(aData), aSize);
+  }
+
+  std::lock_guard<std::mutex> lock(theLock);
+  theSections.push_back(std::move(aSection));
+}
+
+void FlexpointWriter::commit() {
+  // Sections are added in whatever order the saving threads finish; sort them
+  // so that the file contents do not depend on scheduling.
+  std::sort(theSections.begin(), theSections.end(),
+            [](Section const &a, Section const &b) { return a.theName < b.theName; });
+  for (size_t i = 1; i < theSections.size(); ++i) {
+    if (theSections[i].theName == theSections[i - 1].theName) {
+      throw FlexusException(__FILE__, __LINE__,
+                            "Duplicate flexpoint section " + theSections[i].theName);
+    }
+  }
+
+  std::string anIndex;
+  uint64_t anOffset = alignUp(sizeof(FlexpointHeader));
+  for (auto const &aSection : theSections) {
+    appendPOD(anIndex, static_cast<uint32_t>(aSection.theName.size()));
+    anIndex.append(aSection.theName);
+    appendPOD(anIndex, aSection.theCodec);
+    appendPOD(anIndex, anOffset);
+    appendPOD(anIndex, static_cast<uint64_t>(aSection.theData.size()));
+    appendPOD(anIndex, aSection.theRawSize);
+    anOffset = alignUp(anOffset + aSection.theData.size());
+  }
+
+  FlexpointHeader aHeader;
+  std::memcpy(aHeader.theMagic, kFlexpointMagic, sizeof(kFlexpointMagic));
+  aHeader.theVersion = kFlexpointVersion;
+  aHeader.theSectionCount = theSections.size();
+  aHeader.theIndexOffset = anOffset;
+  aHeader.theIndexSize = anIndex.size();
+
+  // Write to a temporary and rename, so a crash never leaves a truncated
+  // flexpoint that would shadow the legacy per-component files.
+  std::string aTemporary = theFilename + ".tmp";
+  int fd = ::open(aTemporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw FlexusException(__FILE__, __LINE__, "Unable to create flexpoint " + aTemporary);
+  }
+  try {
+    std::string aPad(kFlexpointAlign, '\0');
+    uint64_t aPosition = 0;
+    auto put = [&](char const *aData, size_t aSize) {
+      writeAll(fd, aData, aSize, aTemporary);
+      aPosition += aSize;
+    };
+    auto pad = [&]() { put(aPad.data(), alignUp(aPosition) - aPosition); };
+
+    put(reinterpret_cast<char const *>(&aHeader), sizeof(aHeader));
+    pad();
+    for (auto const &aSection : theSections) {
+      put(aSection.theData.data(), aSection.theData.size());
+      pad();
+    }
+    put(anIndex.data(), anIndex.size());
+  } catch (...) {
+    ::close(fd);
+    ::unlink(aTemporary.c_str());
+    throw;
+  }
+  if (::close(fd) != 0 || std::rename(aTemporary.c_str(), theFilename.c_str()) != 0) {
+    ::unlink(aTemporary.c_str());
+    throw FlexusException(__FILE__, __LINE__, "Unable to write flexpoint " + theFilename);
+  }
+  DBG_(Dev, (<< "Wrote flexpoint " << theFilename << " with " << theSections.size()
+             << " sections"));
+  theSections.clear();
+}
+
+FlexpointReader::FlexpointReader(std::string const &aFilename)
+    : theFilename(aFilename), theMapping(nullptr), theMappingSize(0) {
+}
+
+FlexpointReader::~FlexpointReader() {
+  if (theMapping) {
+    ::munmap(const_cast<char *>(theMapping), theMappingSize);
+  }
+}
+
+std::unique_ptr<FlexpointReader> FlexpointReader::open(std::string const &aFilename) {
+  int fd = ::open(aFilename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::unique_ptr<FlexpointReader>();
+  }
+  struct stat aStat;
+  if (::fstat(fd, &aStat) != 0) {
+    ::close(fd);
+    throw FlexusException(__FILE__, __LINE__, "Unable to stat flexpoint " + aFilename);
+  }
+
+  std::unique_ptr<FlexpointReader> aReader(new FlexpointReader(aFilename));
+  aReader->theMappingSize = aStat.st_size;
+  if (aReader->theMappingSize > 0) {
+    void *aMapping = ::mmap(nullptr, aReader->theMappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (aMapping == MAP_FAILED) {
+      ::close(fd);
+      throw FlexusException(__FILE__, __LINE__, "Unable to map flexpoint " + aFilename);
+    }
+    aReader->theMapping = static_cast<char const *>(aMapping);
+  }
+  ::close(fd);
+
+  char const *aBegin = aReader->theMapping;
+  char const *anEnd = aBegin + aReader->theMappingSize;
+  char const *aCursor = aBegin;
+  FlexpointHeader aHeader;
+  if (!readPOD(aCursor, anEnd, aHeader) ||
+      std::memcmp(aHeader.theMagic, kFlexpointMagic, sizeof(kFlexpointMagic)) != 0 ||
+      aHeader.theVersion != kFlexpointVersion ||
+      aHeader.theIndexOffset + aHeader.theIndexSize > aReader->theMappingSize) {
+    throw FlexusException(__FILE__, __LINE__, "Invalid flexpoint " + aFilename);
+  }
+
+  aCursor = aBegin + aHeader.theIndexOffset;
+  char const *anIndexEnd = aCursor + aHeader.theIndexSize;
+  for (uint32_t i = 0; i < aHeader.theSectionCount; ++i) {
+    uint32_t aNameLength;
+    Entry anEntry;
+    if (!readPOD(aCursor, anIndexEnd, aNameLength) || anIndexEnd - aCursor < aNameLength) {
+      throw FlexusException(__FILE__, __LINE__, "Corrupt flexpoint index in " + aFilename);
+    }
+    std::string aName(aCursor, aNameLength);
+    aCursor += aNameLength;
+    if (!readPOD(aCursor, anIndexEnd, anEntry.theCodec) ||
+        !readPOD(aCursor, anIndexEnd, anEntry.theOffset) ||
+        !readPOD(aCursor, anIndexEnd, anEntry.theStoredSize) ||
+        !readPOD(aCursor, anIndexEnd, anEntry.theRawSize) ||
+        anEntry.theOffset + anEntry.theStoredSize > aHeader.theIndexOffset ||
+        anEntry.theCodec > kFlexpointZlib) {
+      throw FlexusException(__FILE__, __LINE__, "Corrupt flexpoint index in " + aFilename);
+    }
+    aReader->theIndex[aName] = anEntry;
+  }
+  DBG_(Dev, (<< "Opened flexpoint " << aFilename << " with " << aReader->theIndex.size()
+             << " sections"));
+  return aReader;
+}
+
+bool FlexpointReader::section(std::string const &aName, FlexpointSection &aSection) const {
+  auto iter = theIndex.find(aName);
+  if (iter == theIndex.end()) {
+    return false;
+  }
+  Entry const &anEntry = iter->second;
+  char const *aStored = theMapping + anEntry.theOffset;
+  if (anEntry.theCodec == kFlexpointRaw) {
+    aSection.theBuffer.clear();
+    aSection.theData = aStored;
+    aSection.theSize = anEntry.theStoredSize;
+    return true;
+  }
+
+  aSection.theBuffer.resize(anEntry.theRawSize);
+  uLongf aLength = anEntry.theRawSize;
+  if (uncompress(reinterpret_cast<Bytef *>(&aSection.theBuffer[0]), &aLength,
+                 reinterpret_cast<Bytef const *>(aStored), anEntry.theStoredSize) != Z_OK ||
+      aLength != anEntry.theRawSize) {
+    throw FlexusException(__FILE__, __LINE__,
+                          "Corrupt flexpoint section " + aName + " in " + theFilename);
+  }
+  aSection.theData = aSection.theBuffer.data();
+  aSection.theSize = aLength;
+  return true;
+}
+
+void flexpointParallelFor(size_t aCount, std::function<void(size_t)> const &aBody) {
+  size_t aThreads = std::thread::hardware_concurrency();
+  if (char const *threads = getenv("FLEXUS_FLEXPOINT_THREADS")) {
+    aThreads = std::strtoul(threads, nullptr, 0);
+  }
+  aThreads = std::max<size_t>(1, std::min(aThreads, aCount));
+
+  std::atomic<size_t> aNext(0);
+  std::mutex anErrorLock;
+  std::exception_ptr anError;
+  auto aWorker = [&]() {
+    size_t idx;
+    while ((idx = aNext.fetch_add(1)) < aCount) {
+      try {
+        aBody(idx);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(anErrorLock);
+        if (!anError) {
+          anError = std::current_exception();
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> aPool;
+  for (size_t i = 1; i < aThreads; ++i) {
+    aPool.emplace_back(aWorker);
+  }
+  aWorker();
+  for (auto &aThread : aPool) {
+    aThread.join();
+  }
+  if (anError) {
+    std::rethrow_exception(anError);
+  }
+}
+
+} // End Namespace Core
+} // namespace Flexus
@@ -0,0 +1,184 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#ifndef FLEXUS_FLEXPOINT_HPP_INCLUDED
+#define FLEXUS_FLEXPOINT_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Flexus {
+namespace Core {
+
+// Unified flexpoint container.  All components that support it save their
+// checkpoint state as named sections of one file per checkpoint directory:
+//
+//   header   magic, version, section count, offset of the index
+//   sections one blob per section, each starting on a page boundary
+//   index    name, codec, offset, stored size and raw size of every section
+//
+// Uncompressed sections are used in place from a read-only mapping of the
+// file, so fixed-layout arrays (tags, states, TLB entries) load with a single
+// bulk copy.  Sections may instead be zlib-compressed individually.
+enum FlexpointCodec : uint32_t { kFlexpointRaw = 0, kFlexpointZlib = 1 };
+
+std::string flexpointFileName(std::string const &aDirectory);
+
+class FlexpointWriter {
+  struct Section {
+    std::string theName;
+    uint32_t theCodec;
+    uint64_t theRawSize;
+    std::string theData;
+  };
+
+  std::string theFilename;
+  std::mutex theLock;
+  std::vector<Section> theSections;
+
+public:
+  explicit FlexpointWriter(std::string const &aFilename);
+
+  // May be called concurrently by components saving in parallel.  Compression
+  // happens on the calling thread.
+  void addSection(std::string const &aName, void const *aData, size_t aSize,
+                  FlexpointCodec aCodec = kFlexpointRaw);
+  void addSection(std::string const &aName, std::string const &aData,
+                  FlexpointCodec aCodec = kFlexpointRaw) {
+    addSection(aName, aData.data(), aData.size(), aCodec);
+  }
+
+  template <class T>
+  void addArray(std::string const &aName, std::vector<T> const &anArray,
+                FlexpointCodec aCodec = kFlexpointRaw) {
+    static_assert(std::is_trivially_copyable<T>::value, "flexpoint arrays must be POD");
+    addSection(aName, anArray.data(), anArray.size() * sizeof(T), aCodec);
+  }
+
+  bool empty() const {
+    return theSections.empty();
+  }
+
+  // Write the file.  Throws FlexusException on I/O errors.
+  void commit();
+};
+
+class FlexpointSection {
+  friend class FlexpointReader;
+
+  char const *theData;
+  size_t theSize;
+  std::string theBuffer; // Decompressed copy, for compressed sections
+
+public:
+  FlexpointSection() : theData(nullptr), theSize(0) {
+  }
+
+  char const *data() const {
+    return theData;
+  }
+  size_t size() const {
+    return theSize;
+  }
+  std::string str() const {
+    return std::string(theData, theSize);
+  }
+
+  template <class T> bool copyTo(std::vector<T> &anArray) const {
+    static_assert(std::is_trivially_copyable<T>::value, "flexpoint arrays must be POD");
+    if (theSize % sizeof(T) != 0) {
+      return false;
+    }
+    anArray.resize(theSize / sizeof(T));
+    if (theSize > 0) {
+      std::memcpy(anArray.data(), theData, theSize);
+    }
+    return true;
+  }
+};
+
+class FlexpointReader {
+  struct Entry {
+    uint32_t theCodec;
+    uint64_t theOffset;
+    uint64_t theStoredSize;
+    uint64_t theRawSize;
+  };
+
+  std::string theFilename;
+  std::map<std::string, Entry> theIndex;
+  char const *theMapping;
+  size_t theMappingSize;
+
+  FlexpointReader(std::string const &aFilename);
+
+public:
+  // Returns an empty pointer if the file does not exist.  Throws
+  // FlexusException if it exists but is not a valid flexpoint.
+  static std::unique_ptr<FlexpointReader> open(std::string const &aFilename);
+  ~FlexpointReader();
+
+  bool contains(std::string const &aName) const {
+    return theIndex.count(aName) > 0;
+  }
+
+  // Thread-safe; returns false if there is no such section
+  bool section(std::string const &aName, FlexpointSection &aSection) const;
+};
+
+// Run aBody(0) .. aBody(aCount - 1) on up to FLEXUS_FLEXPOINT_THREADS host
+// threads (default: all hardware threads).  Exceptions are rethrown here.
+void flexpointParallelFor(size_t aCount, std::function<void(size_t)> const &aBody);
+
+} // End Namespace Core
+} // namespace Flexus
+
+#endif // FLEXUS_FLEXPOINT_HPP_INCLUDED
@@ -42,12 +42,19 @@
 // LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //  DO-NOT-REMOVE end-copyright-block
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -58,6 +65,7 @@
 #include <core/configuration.hpp>
 #include <core/debug/debug.hpp>
 #include <core/performance/profile.hpp>
+#include <core/pool_alloc.hpp>
 
 #include <core/drive_reference.hpp>
 #include <core/metaprogram.hpp>
@@ -98,6 +106,106 @@ namespace Core {
 using Flexus::Wiring::theDrive;
 using namespace std::chrono;
 
+// Compresses and writes stats_db backups on a worker thread.  The simulation
+// thread only pays for serializing the StatManager into memory.  Each file
+// has one pending slot: if the worker is still busy when a new snapshot of
+// the same file is posted, the older pending snapshot of that file is
+// dropped, since only the newest one matters.  A snapshot is moved from the
+// caller into its pending slot and from there to the worker, which frees it
+// once written; only its hash is kept to recognize an unchanged snapshot.
+class StatsWriter {
+  std::thread theThread;
+  std::mutex theLock;
+  std::condition_variable theCondition;
+  std::map<std::string, std::string> thePending;
+  bool theBusy;
+  bool theStop;
+
+  // Only touched by the worker thread
+  std::string theLastName;
+  std::size_t theLastSize;
+  std::size_t theLastHash;
+
+public:
+  StatsWriter() : theBusy(false), theStop(false), theLastSize(0), theLastHash(0) {
+  }
+  ~StatsWriter() {
+    {
+      std::lock_guard<std::mutex> lock(theLock);
+      theStop = true;
+    }
+    theCondition.notify_all();
+    if (theThread.joinable()) {
+      theThread.join();
+    }
+  }
+
+  void post(std::string const &aFilename, std::string &&aSnapshot) {
+    std::lock_guard<std::mutex> lock(theLock);
+    if (!theThread.joinable()) {
+      theThread = std::thread(&StatsWriter::run, this);
+    }
+    thePending[aFilename] = std::move(aSnapshot);
+    theCondition.notify_all();
+  }
+
+  // Block until every posted snapshot is on disk
+  void flush() {
+    std::unique_lock<std::mutex> lock(theLock);
+    theCondition.wait(lock, [this] { return thePending.empty() && !theBusy; });
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> lock(theLock);
+    while (true) {
+      theCondition.wait(lock, [this] { return !thePending.empty() || theStop; });
+      if (thePending.empty()) {
+        return;
+      }
+      std::string name(thePending.begin()->first);
+      std::string data;
+      data.swap(thePending.begin()->second);
+      thePending.erase(thePending.begin());
+      theBusy = true;
+      lock.unlock();
+
+      write(name, data);
+
+      lock.lock();
+      theBusy = false;
+      theCondition.notify_all();
+    }
+  }
+
+  void write(std::string const &aFilename, std::string const &aSnapshot) {
+    // Nothing changed since the last backup, the file on disk is current
+    std::size_t hash = std::hash<std::string>()(aSnapshot);
+    if (aFilename == theLastName && aSnapshot.size() == theLastSize && hash == theLastHash) {
+      return;
+    }
+
+    std::string fullName = aFilename + std::string(".out.gz");
+    std::string last1Name = aFilename + std::string(".001.out.gz");
+    remove(last1Name.c_str());
+    rename(fullName.c_str(), last1Name.c_str());
+
+    std::ofstream anOstream(fullName.c_str(), std::ios::binary);
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::gzip_compressor());
+    out.push(anOstream);
+    out.write(aSnapshot.data(), aSnapshot.size());
+    out.reset();
+    anOstream.close();
+
+    remove(last1Name.c_str());
+
+    theLastName = aFilename;
+    theLastSize = aSnapshot.size();
+    theLastHash = hash;
+  }
+};
+
 class FlexusImpl : public FlexusInterface {
 private:
   uint64_t theWatchdogTimeout;
@@ -112,8 +220,10 @@ private:
   uint64_t theStopCycle;
   Stat::StatCounter theCycleCountStat;
 
-  std::string theCurrentStatRegionName;
-  uint32_t theCurrentStatRegion;
+  uint64_t theLastTimestamp;
+  uint64_t theLastStats;
+  uint64_t theLastRegion;
+  uint64_t theLastProfile;
 
   typedef std::vector<std::function<void()>> void_fn_vector;
   void_fn_vector theTerminateFunctions;
@@ -125,10 +235,22 @@ private:
 
   bool theFastMode;
 
+  // Idle-cycle skipping: off, on, or verify (step every cycle, but check that
+  // no component finds work during a window it reported as idle).  Off by
+  // default; set with set-idle-skip or the FLEXUS_IDLE_SKIP environment
+  // variable, since QEMU builds have no Flexus command line.
+  enum eIdleSkip { kIdleSkipOff, kIdleSkipOn, kIdleSkipVerify } theIdleSkip;
+  uint64_t theIdleUntil;
+
   int32_t theBreakCPU;
   uint64_t theBreakInsn;
   int32_t theSaveCtr;
 
+  mutable StatsWriter theStatsWriter;
+
+  uint64_t nextHousekeepingCycle() const;
+  uint64_t cyclesToNextEvent();
+
 public:
   // Initialization functions
   void initializeComponents();
@@ -177,6 +299,7 @@ public:
   void setStopCycle(std::string const &aValue);
   void setStatInterval(std::string const &aValue);
   void setRegionInterval(std::string const &aValue);
+  void setIdleSkip(std::string const &aValue);
   void setBreakCPU(int32_t aCPU);
   void setBreakInsn(std::string const &aValue);
   void setProfileInterval(std::string const &aValue);
@@ -202,6 +325,7 @@ public:
   void doLoad(std::string const &aDirName);
   void doSave(std::string const &aDirName, bool justFlexus = false);
   void backupStats(std::string const &aFilename) const;
+  void postStats(std::string const &aFilename) const;
   void saveStats(std::string const &aFilename) const;
   void saveStatsUncompressed(std::ofstream &anOstream) const;
   void saveStatsCompressed(std::ofstream &anOstream) const;
@@ -227,8 +351,10 @@ public:
       : theWatchdogTimeout(100000), theNumWatchdogs(0), theInitialized(false), theCycleCount(0),
         theStatInterval(1000000), theRegionInterval(100000000), theProfileInterval(1000000),
         theTimestampInterval(100000), theStopCycle(2000000000), theCycleCountStat("sys-cycles"),
+        theLastTimestamp(0), theLastStats(0), theLastRegion(0), theLastProfile(0),
         theWatchdogWarning(false), theQuiesceRequested(false), theSaveRequested(false),
-        theFastMode(false), theBreakCPU(-1), theBreakInsn(0), theSaveCtr(1) {
+        theFastMode(false), theIdleSkip(kIdleSkipOff), theIdleUntil(0), theBreakCPU(-1),
+        theBreakInsn(0), theSaveCtr(1) {
     Flexus::Dbg::Debugger::theDebugger->connectCycleCount(&theCycleCount);
   }
 #else
@@ -236,8 +362,10 @@ public:
       : theWatchdogTimeout(100000), theNumWatchdogs(0), theInitialized(false), theCycleCount(0),
         theStatInterval(100), theRegionInterval(100000000), theProfileInterval(1000000),
         theTimestampInterval(100000), theStopCycle(2000000000), theCycleCountStat("sys-cycles"),
+        theLastTimestamp(0), theLastStats(0), theLastRegion(0), theLastProfile(0),
         theWatchdogWarning(false), theQuiesceRequested(false), theSaveRequested(false),
-        theFastMode(false), theBreakCPU(-1), theBreakInsn(0), theSaveCtr(1) {
+        theFastMode(false), theIdleSkip(kIdleSkipOff), theIdleUntil(0), theBreakCPU(-1),
+        theBreakInsn(0), theSaveCtr(1) {
     Flexus::Dbg::Debugger::theDebugger->connectCycleCount(&theCycleCount);
   }
 #endif
@@ -261,14 +389,14 @@ void FlexusImpl::printMMU(int32_t aCPU) {
 void FlexusImpl::initializeComponents() {
   DBG_(VVerb, (<< "Inititializing Flexus components..."));
   Stat::getStatManager()->initialize();
-  theCurrentStatRegion = 0;
-  theCurrentStatRegionName =
-      std::string("Region ") + boost::padded_string_cast<3, '0'>(theCurrentStatRegion++);
-  Stat::getStatManager()->openMeasurement(theCurrentStatRegionName);
+  Stat::getStatManager()->openRegions("Region ");
   parseConfiguration(config_file);
   writeConfiguration("configuration.out");
   ConfigurationManager::getConfigurationManager().checkAllOverrides();
   ComponentManager::getComponentManager().initComponents();
+  if (char const *idle_skip = getenv("FLEXUS_IDLE_SKIP")) {
+    setIdleSkip(idle_skip);
+  }
   theInitialized = true;
 }
 
@@ -293,12 +421,11 @@ void FlexusImpl::advanceCycles(int64_t aCycleCount) {
   }
 
   // Check how much time has elapsed every 1024*1024 cycles
-  static uint64_t last_timestamp = 0;
-  if (!theCycleCount || theCycleCount - last_timestamp >= theTimestampInterval) {
+  if (!theCycleCount || theCycleCount - theLastTimestamp >= theTimestampInterval) {
     system_clock::time_point now(system_clock::now());
     auto tt = system_clock::to_time_t(now);
     DBG_(Dev, Core()(<< "Timestamp: " << std::asctime(std::localtime(&tt))));
-    last_timestamp = theCycleCount;
+    theLastTimestamp = theCycleCount;
   }
 
   if ((theStopCycle > 0) && (theCycleCount >= theStopCycle)) {
@@ -306,36 +433,30 @@ void FlexusImpl::advanceCycles(int64_t aCycleCount) {
     terminateSimulation();
   }
 
-  static uint64_t last_stats = 0;
-  if (theCycleCount - last_stats >= theStatInterval) {
+  if (theCycleCount - theLastStats >= theStatInterval) {
     DBG_(Dev, Core()(<< "Saving stats at: " << theCycleCount));
-    backupStats("stats_db");
+    postStats("stats_db");
 
 #ifdef WRITE_ALL_MEASUREMENT_OUT
     writeMeasurement("all", "all.measurement.out");
 #endif
 
-    last_stats = theCycleCount;
+    theLastStats = theCycleCount;
   }
 
-  static uint64_t last_region = 0;
-  if (theCycleCount - last_region >= theRegionInterval) {
-    Stat::getStatManager()->closeMeasurement(theCurrentStatRegionName);
-    theCurrentStatRegionName =
-        std::string("Region ") + boost::padded_string_cast<3, '0'>(theCurrentStatRegion++);
-    Stat::getStatManager()->openMeasurement(theCurrentStatRegionName);
-
-    last_region = theCycleCount;
+  if (theCycleCount - theLastRegion >= theRegionInterval) {
+    samplePools();
+    Stat::getStatManager()->closeRegion();
+    theLastRegion = theCycleCount;
   }
 
-  static uint64_t last_profile = 0;
-  if (theProfileInterval > 0 && theCycleCount - last_profile >= theProfileInterval) {
+  if (theProfileInterval > 0 && theCycleCount - theLastProfile >= theProfileInterval) {
     // DBG_(Dev, Core() ( << "Writing profile at: " << theCycleCount));
     DBG_(Dev, Core()(<< "Profiling disabled"));
 
     // writeProfile("profile.out");
     // resetProfile();
-    last_profile = theCycleCount;
+    theLastProfile = theCycleCount;
   }
 
   Flexus::Dbg::Debugger::theDebugger->checkAt();
@@ -347,12 +468,69 @@ void FlexusImpl::invokeDrives() {
   theDrive.doCycle();
 }
 
+// The first cycle after theCycleCount at which advanceCycles() or doCycle()
+// have housekeeping to do (stats, regions, watchdog, debugger actions, ...).
+// Idle-cycle skipping never jumps past such a cycle, so that it is
+// indistinguishable from stepping one cycle at a time.
+uint64_t FlexusImpl::nextHousekeepingCycle() const {
+  uint64_t next = (theCycleCount | 0xFF) + 1; // watchdog check
+
+  if (theStopCycle > 0) {
+    next = std::min(next, theStopCycle);
+  }
+  next = std::min(next, theLastTimestamp + theTimestampInterval);
+  next = std::min(next, theLastStats + theStatInterval);
+  next = std::min(next, theLastRegion + theRegionInterval);
+  if (theProfileInterval > 0) {
+    next = std::min(next, theLastProfile + theProfileInterval);
+  }
+
+  int64_t next_at = Flexus::Dbg::Debugger::theDebugger->nextAt();
+  if (next_at > static_cast<int64_t>(theCycleCount)) {
+    next = std::min(next, static_cast<uint64_t>(next_at));
+  }
+
+  // Stat ticks advance in lock-step with theCycleCount
+  int64_t next_stat_event = Stat::getStatManager()->nextEventTick();
+  int64_t ticks = Stat::getStatManager()->ticks();
+  if (next_stat_event != std::numeric_limits<int64_t>::max()) {
+    next = std::min(next, theCycleCount + std::max<int64_t>(next_stat_event - ticks, 1));
+  }
+
+  return next;
+}
+
+// Number of cycles to advance before the drives need to be called again.
+// This is 1 unless every drive reports that it is idle until some future
+// cycle, in which case the intervening cycles are skipped entirely.
+uint64_t FlexusImpl::cyclesToNextEvent() {
+  if (theQuiesceRequested || theIdleSkip == kIdleSkipOff) {
+    return 1;
+  }
+  uint64_t next = theDrive.nextEventCycle(theCycleCount);
+  if (theIdleSkip == kIdleSkipVerify) {
+    // Inside a window that would have been skipped, nothing may wake up early
+    DBG_Assert(theCycleCount + 1 >= theIdleUntil || next >= theIdleUntil,
+               Core()(<< "Idle-cycle skip would have missed work at cycle " << theCycleCount + 1
+                      << " (window ends at " << theIdleUntil << ", next event " << next << ")"));
+    if (theCycleCount + 1 >= theIdleUntil) {
+      theIdleUntil = std::min(next, nextHousekeepingCycle());
+    }
+    return 1;
+  }
+  if (next <= theCycleCount + 1) {
+    return 1;
+  }
+  next = std::min(next, nextHousekeepingCycle());
+  return (next > theCycleCount) ? next - theCycleCount : 1;
+}
+
 void FlexusImpl::doCycle() {
   FLEXUS_PROFILE();
 
   FLEXUS_DBG("--------------START FLEXUS CYCLE " << theCycleCount << " ------------------------");
 
-  advanceCycles(1);
+  advanceCycles(cyclesToNextEvent());
 
   uint32_t recent_watchdog_count = ((uint32_t)theCycleCount) & 0xFF;
   if (recent_watchdog_count == 0) {
@@ -426,6 +604,22 @@ void FlexusImpl::setRegionInterval(std::string const &aValue) {
   DBG_(Dev, Set((Source) << "flexus")(<< "Set region interval to : " << theRegionInterval));
 }
 
+void FlexusImpl::setIdleSkip(std::string const &aValue) {
+  if (aValue == "off") {
+    theIdleSkip = kIdleSkipOff;
+  } else if (aValue == "on") {
+    theIdleSkip = kIdleSkipOn;
+  } else if (aValue == "verify") {
+    theIdleSkip = kIdleSkipVerify;
+    theIdleUntil = 0;
+  } else {
+    DBG_(Crit, Set((Source) << "flexus")(<< "Unknown idle-skip mode: " << aValue
+                                         << " (expected off, on or verify)"));
+    return;
+  }
+  DBG_(Dev, Set((Source) << "flexus")(<< "Set idle-cycle skipping to : " << aValue));
+}
+
 void FlexusImpl::setBreakCPU(int32_t aCPU) {
   theBreakCPU = aCPU;
   DBG_(Dev, Set((Source) << "flexus")(<< "Set break CPU to : " << aCPU));
@@ -608,15 +802,18 @@ void FlexusImpl::doSave(std::string const &aDirName, bool justFlexus) {
 #endif
 }
 
+// Explicit backups (e.g. QMP backup-stats) are on disk when this returns
 void FlexusImpl::backupStats(std::string const &aFilename) const {
-  std::string fullName = aFilename + std::string(".out.gz");
-  std::string last1Name = aFilename + std::string(".001.out.gz");
-  remove(last1Name.c_str());
-  rename(fullName.c_str(), last1Name.c_str());
-
-  saveStats(fullName);
+  postStats(aFilename);
+  theStatsWriter.flush();
+}
 
-  remove(last1Name.c_str());
+// Periodic backups are written in the background
+void FlexusImpl::postStats(std::string const &aFilename) const {
+  samplePools();
+  std::ostringstream snapshot(std::ios::binary);
+  Stat::getStatManager()->save(snapshot);
+  theStatsWriter.post(aFilename, snapshot.str());
 }
 
 void FlexusImpl::saveStats(std::string const &aFilename) const {
@@ -820,6 +1017,9 @@ public:
     aClass.addCommand(&FlexusImpl::setRegionInterval, "set-region-interval",
                       "Interval between stats regions", "value");
 
+    aClass.addCommand(&FlexusImpl::setIdleSkip, "set-idle-skip",
+                      "Skip cycles in which every component is idle (off, on, verify)", "mode");
+
     // State saving/loading commands
     aClass.addCommand(&FlexusImpl::saveState, "save-state",
                       "Write out a checkpoint of Flexus state", "dirname");
@@ -0,0 +1,116 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#include <cxxabi.h>
+#include <cstdlib>
+
+#include <core/pool_alloc.hpp>
+#include <core/stats.hpp>
+
+namespace Flexus {
+namespace Core {
+
+namespace {
+struct PoolStats {
+  PoolCounters *theCounters;
+  Stat::StatCounter *theLive;
+  Stat::StatMax *thePeak;
+  Stat::StatCounter *theSlabs;
+  int64_t theSampledLive;
+  int64_t theSampledSlabs;
+};
+
+std::mutex &poolLock() {
+  static std::mutex theLock;
+  return theLock;
+}
+
+std::vector<PoolStats> &pools() {
+  static std::vector<PoolStats> thePools;
+  return thePools;
+}
+
+// "Flexus::SharedTypes::MemoryMessage" -> "MemoryMessage"
+std::string poolName(char const *aMangledTypeName) {
+  int status = 0;
+  char *demangled = abi::__cxa_demangle(aMangledTypeName, nullptr, nullptr, &status);
+  std::string name(status == 0 ? demangled : aMangledTypeName);
+  std::free(demangled);
+  size_t scope = name.rfind("::");
+  if (scope != std::string::npos) {
+    name = name.substr(scope + 2);
+  }
+  return name;
+}
+} // namespace
+
+PoolCounters::PoolCounters(char const *aMangledTypeName)
+    : theName(poolName(aMangledTypeName)), theLive(0), thePeak(0), theSlabs(0) {
+  std::lock_guard<std::mutex> lock(poolLock());
+  pools().push_back(PoolStats{this, nullptr, nullptr, nullptr, 0, 0});
+}
+
+void samplePools() {
+  std::lock_guard<std::mutex> lock(poolLock());
+  for (auto &aPool : pools()) {
+    // Stats are created here rather than with the pool, since the first
+    // allocation of a type may happen on a worker thread.
+    if (!aPool.theLive) {
+      std::string prefix("sys-Pool-" + aPool.theCounters->theName);
+      aPool.theLive = new Stat::StatCounter(prefix + "-Live");
+      aPool.thePeak = new Stat::StatMax(prefix + "-PeakLive");
+      aPool.theSlabs = new Stat::StatCounter(prefix + "-Slabs");
+    }
+    int64_t live = aPool.theCounters->theLive.load(std::memory_order_relaxed);
+    int64_t slabs = aPool.theCounters->theSlabs.load(std::memory_order_relaxed);
+    *aPool.theLive += live - aPool.theSampledLive;
+    *aPool.theSlabs += slabs - aPool.theSampledSlabs;
+    *aPool.thePeak << aPool.theCounters->thePeak.load(std::memory_order_relaxed);
+    aPool.theSampledLive = live;
+    aPool.theSampledSlabs = slabs;
+  }
+}
+
+} // namespace Core
+} // namespace Flexus
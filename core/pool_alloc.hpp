@@ -0,0 +1,212 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#ifndef FLEXUS_POOL_ALLOC_HPP_INCLUDED
+#define FLEXUS_POOL_ALLOC_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace Flexus {
+namespace Core {
+
+// Allocation counters of one pool, shared by every thread that uses it.  The
+// simulation thread publishes them as sys-Pool-<type>-* stats in samplePools().
+// Pools count objects, except for pools of mixed sizes, which count bytes.
+struct PoolCounters {
+  std::string const theName;
+  std::atomic<int64_t> theLive;
+  std::atomic<int64_t> thePeak;
+  std::atomic<int64_t> theSlabs;
+
+  PoolCounters(char const *aMangledTypeName);
+
+  void allocated(int64_t aCount = 1) {
+    int64_t live = theLive.fetch_add(aCount, std::memory_order_relaxed) + aCount;
+    if (live > thePeak.load(std::memory_order_relaxed)) {
+      thePeak.store(live, std::memory_order_relaxed);
+    }
+  }
+  void released(int64_t aCount = 1) {
+    theLive.fetch_sub(aCount, std::memory_order_relaxed);
+  }
+};
+
+void samplePools();
+
+// Slab pool for objects of type T.  Each thread allocates from and frees to its
+// own free list.  Free lists trade fixed-size batches with a shared depot, so
+// objects freed by a different thread than the one that allocated them (e.g.
+// messages crossing from a core to the shared caches) are reused rather than
+// piling up.  Slabs are never returned to the heap.
+template <class T> class SlabPool {
+  struct FreeBlock {
+    FreeBlock *theNext;
+  };
+
+  static const size_t kAlign = alignof(T) > alignof(FreeBlock) ? alignof(T) : alignof(FreeBlock);
+  static const size_t kBlockSize =
+      ((sizeof(T) > sizeof(FreeBlock) ? sizeof(T) : sizeof(FreeBlock)) + kAlign - 1) &
+      ~(kAlign - 1);
+  static const size_t kBatch = 64;
+  static const size_t kSlabBlocks = 16 * kBatch;
+  static_assert(kAlign <= alignof(std::max_align_t), "over-aligned types are not pooled");
+
+  struct ThreadCache {
+    FreeBlock *theHead;
+    size_t theCount;
+  };
+
+  struct Depot {
+    std::mutex theLock;
+    std::vector<FreeBlock *> theBatches;
+    PoolCounters theCounters;
+    Depot() : theCounters(typeid(T).name()) {
+    }
+  };
+
+  static ThreadCache &cache() {
+    static thread_local ThreadCache theCache = {nullptr, 0};
+    return theCache;
+  }
+  static Depot &depot() {
+    static Depot theDepot;
+    return theDepot;
+  }
+
+  static void refill(ThreadCache &aCache) {
+    Depot &shared = depot();
+    {
+      std::lock_guard<std::mutex> lock(shared.theLock);
+      if (!shared.theBatches.empty()) {
+        aCache.theHead = shared.theBatches.back();
+        aCache.theCount = kBatch;
+        shared.theBatches.pop_back();
+        return;
+      }
+    }
+    char *slab = static_cast<char *>(::operator new(kSlabBlocks * kBlockSize));
+    for (size_t i = 0; i < kSlabBlocks; ++i) {
+      FreeBlock *block = reinterpret_cast<FreeBlock *>(slab + i * kBlockSize);
+      block->theNext = aCache.theHead;
+      aCache.theHead = block;
+    }
+    aCache.theCount = kSlabBlocks;
+    shared.theCounters.theSlabs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  static void spill(ThreadCache &aCache) {
+    FreeBlock *batch = aCache.theHead;
+    FreeBlock *last = batch;
+    for (size_t i = 1; i < kBatch; ++i) {
+      last = last->theNext;
+    }
+    aCache.theHead = last->theNext;
+    aCache.theCount -= kBatch;
+    last->theNext = nullptr;
+    Depot &shared = depot();
+    std::lock_guard<std::mutex> lock(shared.theLock);
+    shared.theBatches.push_back(batch);
+  }
+
+public:
+  static void *allocate() {
+    ThreadCache &local = cache();
+    if (!local.theHead) {
+      refill(local);
+    }
+    FreeBlock *block = local.theHead;
+    local.theHead = block->theNext;
+    --local.theCount;
+    depot().theCounters.allocated();
+    return block;
+  }
+
+  static void deallocate(void *aPtr) {
+    ThreadCache &local = cache();
+    FreeBlock *block = static_cast<FreeBlock *>(aPtr);
+    block->theNext = local.theHead;
+    local.theHead = block;
+    if (++local.theCount >= 2 * kBatch) {
+      spill(local);
+    }
+    depot().theCounters.released();
+  }
+};
+
+// Base for intrusive slice types that are created and released at high rates.
+// The last intrusive_ptr_release() deletes through the virtual destructor of
+// counted_base, which reaches these operators with the size of the dynamic
+// type; derived types of a different size fall back to the heap.  Builds with
+// AddressSanitizer bypass the pool so that use-after-free is still caught.
+template <class T> struct PoolAllocated {
+  static void *operator new(size_t aSize) {
+#ifndef __SANITIZE_ADDRESS__
+    if (aSize == sizeof(T)) {
+      return SlabPool<T>::allocate();
+    }
+#endif
+    return ::operator new(aSize);
+  }
+  static void operator delete(void *aPtr, size_t aSize) {
+#ifndef __SANITIZE_ADDRESS__
+    if (aSize == sizeof(T)) {
+      SlabPool<T>::deallocate(aPtr);
+      return;
+    }
+#endif
+    ::operator delete(aPtr);
+  }
+};
+
+} // namespace Core
+} // namespace Flexus
+
+#endif // FLEXUS_POOL_ALLOC_HPP_INCLUDED
@@ -48,6 +48,9 @@
 namespace Flexus {
 namespace Qemu {
 namespace API {
+QEMU_CPU_EXEC_N_PROC QEMU_cpu_execute_n = nullptr;
+QEMU_CPU_TIMER_DEADLINE_PROC QEMU_cpu_timer_deadline = nullptr;
+
 void QEMU_write_configuration_to_file(const char *aFilename) {
   /*Qemu::API::SIM_write_configuration_to_file(aFilename);*/
   // XXX: Does nothing.
@@ -51,6 +51,20 @@ namespace API {
 #include <core/qemu/api.h>
 
 void QEMU_write_configuration_to_file(const char *aFilename);
+
+// Executes up to a count of instructions in one call, stopping after the first
+// one that raises, and reports how many ran.  It is not part of the libqflex
+// hook table: QEMU registers it through qflex_set_batched_execute() when it
+// supports it, and Processor::advance() steps one instruction at a time
+// otherwise.
+typedef int (*QEMU_CPU_EXEC_N_PROC)(conf_object_t *, int, int *);
+extern QEMU_CPU_EXEC_N_PROC QEMU_cpu_execute_n;
+
+// Returns the number of cycles until the next timer event of a cpu, or
+// UINT64_MAX if none is armed.  Like QEMU_cpu_execute_n, QEMU registers it
+// through qflex_set_timer_deadline() when it supports it.
+typedef uint64_t (*QEMU_CPU_TIMER_DEADLINE_PROC)(conf_object_t *);
+extern QEMU_CPU_TIMER_DEADLINE_PROC QEMU_cpu_timer_deadline;
 } // namespace API
 } // namespace Qemu
 } // namespace Flexus
@@ -221,6 +221,15 @@ public:
     return API::QEMU_cpu_has_work(*this);
   }
 
+  // Cycles until the next timer event of this cpu, or UINT64_MAX if QEMU does
+  // not report its timer deadlines
+  uint64_t timerDeadline() const {
+    if (API::QEMU_cpu_timer_deadline) {
+      return API::QEMU_cpu_timer_deadline(*this);
+    }
+    return UINT64_MAX;
+  }
+
   uint64_t readPC() const {
     return API::QEMU_get_program_counter(*this);
   }
@@ -310,6 +319,22 @@ public:
     exception = Qemu::API::QEMU_cpu_execute(theProcessor);
     return exception;
   }
+
+  // Execute up to aCount instructions, stopping after the first one that
+  // raises.  anExecuted counts the executed instructions, including that one.
+  int advance(int32_t aCount, int32_t &anExecuted) {
+    if (Qemu::API::QEMU_cpu_execute_n) {
+      int executed = 0;
+      int exception = Qemu::API::QEMU_cpu_execute_n(theProcessor, aCount, &executed);
+      anExecuted = executed;
+      return exception;
+    }
+    int exception = 0;
+    for (anExecuted = 0; anExecuted < aCount && exception == 0; ++anExecuted) {
+      exception = Qemu::API::QEMU_cpu_execute(theProcessor);
+    }
+    return exception;
+  }
 };
 
 #define PROCESSOR_IMPL armProcessorImpl
@@ -64,6 +64,7 @@ namespace API {
 } // namespace API
 } // namespace Qemu
 } // namespace Flexus
+#include <core/qemu/api_wrappers.hpp>
 
 #include <fstream>
 
@@ -221,6 +222,15 @@ extern "C" void startTiming() {
   Flexus::Qemu::start_timing_sim();
 }
 
+extern "C" void qflex_set_batched_execute(Flexus::Qemu::API::QEMU_CPU_EXEC_N_PROC aHook) {
+  Flexus::Qemu::API::QEMU_cpu_execute_n = aHook;
+}
+
+extern "C" void
+qflex_set_timer_deadline(Flexus::Qemu::API::QEMU_CPU_TIMER_DEADLINE_PROC aHook) {
+  Flexus::Qemu::API::QEMU_cpu_timer_deadline = aHook;
+}
+
 extern "C" void qflex_init(Flexus::Qemu::API::QFLEX_API_Interface_Hooks_t *hooks) {
   Flexus::Qemu::API::QFLEX_API_set_Interface_Hooks(hooks);
 
@@ -108,6 +108,8 @@ struct StatManager {
                                              std::ostream &anOstream,
                                              std::string const &aStatSpec = std::string(".*")) = 0;
   virtual void closeMeasurement(std::string const &aName) = 0;
+  virtual void openRegions(std::string const &aPrefix) = 0;
+  virtual void closeRegion() = 0;
   virtual void listStats(std::ostream &anOstream) = 0;
   virtual void listMeasurements(std::ostream &anOstream) = 0;
   virtual void printMeasurement(std::string const &aMeasurementSpec, std::ostream &anOstream) = 0;
@@ -127,6 +129,7 @@ struct StatManager {
   virtual int64_t ticks() = 0;
   virtual void reduceNodes(std::string const &aMeasurementSpec) = 0;
   virtual void addEvent(int64_t aDeadline, std::function<void()> anEvent) = 0;
+  virtual int64_t nextEventTick() = 0;
   virtual void addFinalizer(std::function<void()> aFinalizer) = 0;
   virtual void save(std::ostream &anOstream) const = 0;
   virtual void load(std::istream &anIstream) = 0;
@@ -155,58 +158,61 @@ public:
   virtual std::string const &type() const = 0;
   virtual aux_::StatValueHandle createValue() = 0;
   virtual aux_::StatValueArrayHandle createValueArray() = 0;
+  // Stats which keep a plain running total expose it here, so that region
+  // boundaries can be recorded without opening measurements.
+  virtual int64_t const *runningTotal() const {
+    return nullptr;
+  }
   friend std::ostream &operator<<(std::ostream &anOstream, Stat const &aStat) {
     anOstream << aStat.name();
     return anOstream;
   }
 };
 
-class StatCounter
-    : public Stat,
-      public aux_::StatUpdaterLink<aux_::StatUpdater<aux_::StatValue_Counter::update_type>> {
+class StatCounter : public Stat {
 
 public:
   typedef aux_::StatValue_Counter stat_value_type;
   typedef aux_::StatValueArray_Counter stat_value_array_type;
 
-  // Updater Link Implementation
 private:
-  typedef aux_::StatUpdater<stat_value_type::update_type> updater_type;
-  updater_type *theUpdater;
+  // Running total of all updates.  Updates touch only this slot; open
+  // measurements compute their values as deltas from snapshots of it.
+  int64_t theCount;
   int64_t theInitialValue;
 
 public:
-  virtual void setNextUpdater(updater_type *aLink) {
-    theUpdater = aLink;
-  }
-
   // Interface to Measurements
   aux_::StatValueHandle createValue() {
-    boost::intrusive_ptr<stat_value_type> new_value(new stat_value_type(theInitialValue));
-    boost::intrusive_ptr<updater_type> new_updater(
-        new aux_::SimpleStatUpdater<stat_value_type, stat_value_type::update_type>(
-            new_value, theInitialValue, this, theUpdater));
+    boost::intrusive_ptr<aux_::StatValue_CounterSnapshot> new_value(
+        new aux_::StatValue_CounterSnapshot(&theCount, theInitialValue));
+    boost::intrusive_ptr<aux_::StatUpdaterBase> new_updater(
+        new aux_::SnapshotStatUpdater<aux_::StatValue_CounterSnapshot>(new_value,
+                                                                       theInitialValue));
     return aux_::StatValueHandle(this, new_value, new_updater);
   }
   aux_::StatValueArrayHandle createValueArray() {
-    boost::intrusive_ptr<stat_value_array_type> new_value(
-        new stat_value_array_type(theInitialValue));
-    boost::intrusive_ptr<updater_type> new_updater(
-        new aux_::SimpleStatUpdater<stat_value_array_type, stat_value_array_type::update_type>(
-            new_value, theInitialValue, this, theUpdater));
+    boost::intrusive_ptr<aux_::StatValueArray_CounterSnapshot> new_value(
+        new aux_::StatValueArray_CounterSnapshot(&theCount, theInitialValue));
+    boost::intrusive_ptr<aux_::StatUpdaterBase> new_updater(
+        new aux_::SnapshotStatUpdater<aux_::StatValueArray_CounterSnapshot>(new_value,
+                                                                            theInitialValue));
     return aux_::StatValueArrayHandle(this, new_value, new_updater);
   }
+  int64_t const *runningTotal() const {
+    return &theCount;
+  }
 
 public:
   // Create a counter with a specific name
   StatCounter(std::string const &aName, int64_t anInitialValue = 0)
-      : Stat(aName), theUpdater(0), theInitialValue(anInitialValue) {
+      : Stat(aName), theCount(0), theInitialValue(anInitialValue) {
     registerStat();
   }
 
   template <class Component>
   StatCounter(std::string const &aName, Component *aComponent, int64_t anInitialValue = 0)
-      : Stat(aComponent->statName() + "-" + aName), theUpdater(0), theInitialValue(anInitialValue) {
+      : Stat(aComponent->statName() + "-" + aName), theCount(0), theInitialValue(anInitialValue) {
     registerStat();
   }
 
@@ -217,39 +223,33 @@ public:
 
   // Increment Counter
   StatCounter &operator++() {
-    if (theUpdater)
-      theUpdater->update(1);
+    ++theCount;
     return *this;
   }
   StatCounter &operator++(int) {
-    if (theUpdater)
-      theUpdater->update(1);
+    ++theCount;
     return *this;
   }
 
   // Decrement Counter
   StatCounter &operator--() {
-    if (theUpdater)
-      theUpdater->update(-1);
+    --theCount;
     return *this;
   }
   StatCounter &operator--(int) {
-    if (theUpdater)
-      theUpdater->update(-1);
+    --theCount;
     return *this;
   }
 
   // Increase Counter
   StatCounter &operator+=(stat_value_type::update_type anUpdate) {
-    if (theUpdater)
-      theUpdater->update(anUpdate);
+    theCount += anUpdate;
     return *this;
   }
 
   // Decrease Counter
   StatCounter &operator-=(stat_value_type::update_type anUpdate) {
-    if (theUpdater)
-      theUpdater->update(-anUpdate);
+    theCount -= anUpdate;
     return *this;
   }
 
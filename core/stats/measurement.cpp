@@ -47,6 +47,7 @@
 #include <iomanip>
 #include <list>
 #include <queue>
+#include <sstream>
 
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
@@ -56,6 +57,7 @@
 #include <boost/throw_exception.hpp>
 #include <functional>
 
+#include <core/boost_extensions/padded_string_cast.hpp>
 #include <core/stats.hpp>
 
 namespace Flexus {
@@ -96,11 +98,6 @@ namespace Stat {
 
 namespace aux_ {
 
-void fold(StatValueBase &anAccumulator, StatValueBase const &anRHS,
-          void (StatValueBase::*aReduction)(StatValueBase const &)) {
-  (anAccumulator.*aReduction)(anRHS);
-}
-
 bool Measurement::includeStat(Stat *aStat) {
   return boost::regex_match(aStat->name(), theStatExpression);
 }
@@ -112,6 +109,25 @@ void SimpleMeasurement ::addToMeasurement(Stat *aStat) {
   }
 }
 
+void SimpleMeasurement ::addValue(std::string const &aStat,
+                                  boost::intrusive_ptr<StatValueBase> aValue) {
+  theStats[aStat] = StatValueHandle(aStat, aValue);
+}
+
+// A copy of aStat's current value, which later updates do not change.  Every
+// stat value returns a copy of itself as its sum accumulator.
+boost::intrusive_ptr<StatValueBase> SimpleMeasurement ::valueOf(std::string const &aStat) {
+  stat_handle_map::iterator iter = theStats.find(aStat);
+  if (iter == theStats.end()) {
+    return nullptr;
+  }
+  try {
+    return iter->second.sumAccumulator();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
 void SimpleMeasurement ::close() {
   stat_handle_map::iterator iter = theStats.begin();
   stat_handle_map::iterator end = theStats.end();
@@ -775,25 +791,25 @@ void SimpleMeasurement ::reduce(eReduction aReduction, Measurement *aMeasurement
         switch (aReduction) {
         case eReduction::eSum: {
           auto accumulator = theStats[aStat.first].getValue();
-          fold(*accumulator, *(aStat.second.getValue()), &StatValueBase::reduceSum);
+          accumulator->reduceSum(*(aStat.second.getValue()));
           theStats[aStat.first].setValue(accumulator);
           break;
         }
         case eReduction::eAverage: {
           auto accumulator = theStats[aStat.first].getValue();
-          fold(*accumulator, *(aStat.second.getValue()), &StatValueBase::reduceAvg);
+          accumulator->reduceAvg(*(aStat.second.getValue()));
           theStats[aStat.first].setValue(accumulator);
           break;
         }
         case eReduction::eStdDev: {
           auto accumulator = theStats[aStat.first].getValue();
-          fold(*accumulator, *(aStat.second.getValue()), &StatValueBase::reduceStdDev);
+          accumulator->reduceStdDev(*(aStat.second.getValue()));
           theStats[aStat.first].setValue(accumulator);
           break;
         }
         case eReduction::eCount: {
           auto accumulator = theStats[aStat.first].getValue();
-          fold(*accumulator, *(aStat.second.getValue()), &StatValueBase::reduceCount);
+          accumulator->reduceCount(*(aStat.second.getValue()));
           theStats[aStat.first].setValue(accumulator);
           break;
         }
@@ -1067,6 +1083,167 @@ void LoggedPeriodicMeasurement ::fire() {
   }
 }
 
+void RegionSeries::clear() {
+  thePrefix.clear();
+  theColumns.clear();
+  theRowEnds.clear();
+  theChangedColumns.clear();
+  theChangedValues.clear();
+  theOtherColumns.clear();
+  theOtherRowEnds.clear();
+  theOtherChangedColumns.clear();
+  theOtherChangedValues.clear();
+  theLive = false;
+  theSources.clear();
+  theLastValues.clear();
+  theAll = nullptr;
+  theOtherLastValues.clear();
+}
+
+void RegionSeries::open(std::string const &aPrefix, std::vector<Stat *> const &aStats,
+                        SimpleMeasurement *anAll) {
+  clear();
+  thePrefix = aPrefix;
+  theLive = true;
+  theAll = anAll;
+  for (auto *aStat : aStats)
+    addStat(aStat);
+  // The first boundary is the baseline for the first region
+  closeRegion();
+}
+
+void RegionSeries::addStat(Stat *aStat) {
+  if (!theLive) {
+    return;
+  }
+  // Earlier boundaries implicitly recorded this column as zero, or as absent
+  if (aStat->runningTotal() == nullptr) {
+    theOtherColumns.push_back(aStat->name());
+    theOtherLastValues.push_back(std::string());
+    return;
+  }
+  theColumns.push_back(aStat->name());
+  theSources.push_back(aStat->runningTotal());
+  theLastValues.push_back(0);
+}
+
+void RegionSeries::changesSince(std::vector<uint32_t> &aColumns,
+                                std::vector<int64_t> &aValues) const {
+  for (uint32_t i = 0; i < theSources.size(); ++i) {
+    int64_t value = *theSources[i];
+    if (value != theLastValues[i]) {
+      aColumns.push_back(i);
+      aValues.push_back(value);
+    }
+  }
+}
+
+// Stat values cannot be compared directly, so a value counts as changed when
+// it prints differently.  This runs only at region boundaries.
+void RegionSeries::otherChangesSince(
+    std::vector<std::string> &aLastValues, std::vector<uint32_t> &aColumns,
+    std::vector<boost::intrusive_ptr<StatValueBase>> &aValues) const {
+  if (theAll == nullptr) {
+    return;
+  }
+  for (uint32_t i = 0; i < theOtherColumns.size(); ++i) {
+    boost::intrusive_ptr<StatValueBase> value(theAll->valueOf(theOtherColumns[i]));
+    if (!value) {
+      continue;
+    }
+    std::ostringstream printed;
+    value->print(printed);
+    if (printed.str() != aLastValues[i]) {
+      aLastValues[i] = printed.str();
+      aColumns.push_back(i);
+      aValues.push_back(value);
+    }
+  }
+}
+
+void RegionSeries::closeRegion() {
+  if (!theLive) {
+    return;
+  }
+  uint64_t row_begin = theChangedColumns.size();
+  changesSince(theChangedColumns, theChangedValues);
+  for (uint64_t i = row_begin; i < theChangedColumns.size(); ++i) {
+    theLastValues[theChangedColumns[i]] = theChangedValues[i];
+  }
+  theRowEnds.push_back(theChangedColumns.size());
+
+  otherChangesSince(theOtherLastValues, theOtherChangedColumns, theOtherChangedValues);
+  theOtherRowEnds.push_back(theOtherChangedColumns.size());
+}
+
+uint32_t RegionSeries::regions() const {
+  if (theRowEnds.empty()) {
+    return 0;
+  }
+  // While recording, the region after the last boundary is still open
+  return theLive ? theRowEnds.size() : theRowEnds.size() - 1;
+}
+
+std::string RegionSeries::regionName(uint32_t aRegion) const {
+  return thePrefix + boost::padded_string_cast<3, '0'>(aRegion);
+}
+
+std::vector<boost::intrusive_ptr<SimpleMeasurement>>
+RegionSeries::materialize(std::set<uint32_t> const &aRegions) const {
+  std::vector<boost::intrusive_ptr<SimpleMeasurement>> result;
+  std::vector<int64_t> totals(theColumns.size(), 0);
+  std::vector<int64_t> start;
+  std::vector<boost::intrusive_ptr<StatValueBase>> others(theOtherColumns.size());
+  std::set<uint32_t>::const_iterator next = aRegions.begin();
+  uint64_t change = 0;
+  uint64_t other_change = 0;
+
+  // Replay the boundaries in order.  Region r starts at boundary r and ends at
+  // boundary r + 1, or at the current totals if it is still open.
+  for (uint32_t row = 0; row <= theRowEnds.size() && next != aRegions.end(); ++row) {
+    if (row < theRowEnds.size()) {
+      for (; change < theRowEnds[row]; ++change) {
+        totals[theChangedColumns[change]] = theChangedValues[change];
+      }
+      for (; row < theOtherRowEnds.size() && other_change < theOtherRowEnds[row];
+           ++other_change) {
+        others[theOtherChangedColumns[other_change]] = theOtherChangedValues[other_change];
+      }
+    } else if (theLive) {
+      for (uint32_t i = 0; i < theSources.size(); ++i) {
+        totals[i] = *theSources[i];
+      }
+      for (uint32_t i = 0; theAll != nullptr && i < theOtherColumns.size(); ++i) {
+        if (boost::intrusive_ptr<StatValueBase> value = theAll->valueOf(theOtherColumns[i])) {
+          others[i] = value;
+        }
+      }
+    } else {
+      break;
+    }
+
+    if (row > 0 && *next == row - 1) {
+      boost::intrusive_ptr<SimpleMeasurement> region(
+          new SimpleMeasurement(regionName(row - 1), ".*"));
+      for (uint32_t i = 0; i < theColumns.size(); ++i) {
+        region->addValue(theColumns[i], new StatValue_Counter(totals[i] - start[i]));
+      }
+      // Copies, so that node reduction of the region leaves the series intact
+      for (uint32_t i = 0; i < theOtherColumns.size(); ++i) {
+        if (others[i]) {
+          region->addValue(theOtherColumns[i], others[i]->sumAccumulator());
+        }
+      }
+      result.push_back(region);
+      ++next;
+    }
+    if (next != aRegions.end() && *next == row) {
+      start = totals;
+    }
+  }
+  return result;
+}
+
 } // namespace aux_
 
 } // namespace Stat
@@ -49,6 +49,7 @@
 #include <boost/regex.hpp>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <list>
 #include <queue>
 
@@ -725,6 +726,8 @@ class StatManagerImpl : public StatManager {
   boost::intrusive_ptr<Measurement> theAllMeasurement;
   std::list<std::function<void()>> theFinalizers;
   bool theLoaded;
+  RegionSeries theRegions;
+  std::vector<std::string> theReducedNodeSpecs;
 
   struct event {
     int64_t theDeadline;
@@ -756,6 +759,7 @@ public:
   void registerStat(Stat *aStat) {
     theStats.push_back(aStat);
     theStatNames.push_back(aStat->name());
+    theRegions.addStat(aStat);
 
     for (auto &aMeasurement : theMeasurements)
       if (aMeasurement.second.get() != nullptr)
@@ -835,8 +839,44 @@ public:
     }
   }
 
+  void openRegions(std::string const &aPrefix) {
+    theRegions.open(aPrefix, theStats,
+                    dynamic_cast<SimpleMeasurement *>(theAllMeasurement.get()));
+  }
+
+  void closeRegion() {
+    theRegions.closeRegion();
+  }
+
+  // Regions are not kept in theMeasurements; the ones matching aSpec are
+  // rebuilt from theRegions every time they are selected.
+  measurement_collection selectMeasurements(boost::regex const &aSpec) const {
+    measurement_collection selected;
+    for (auto &pair : theMeasurements)
+      if (boost::regex_match(pair.first, aSpec))
+        selected.insert(pair);
+
+    std::set<uint32_t> regions;
+    for (uint32_t i = 0; i < theRegions.regions(); ++i) {
+      std::string name(theRegions.regionName(i));
+      if (boost::regex_match(name, aSpec) && theMeasurements.count(name) == 0)
+        regions.insert(i);
+    }
+    for (auto &region : theRegions.materialize(regions)) {
+      for (auto &aReducedSpec : theReducedNodeSpecs) {
+        if (boost::regex_match(region->name(), boost::regex(aReducedSpec))) {
+          region->reduceNodes();
+          break;
+        }
+      }
+      selected[region->name()] = region;
+    }
+    return selected;
+  }
+
   void reduceNodes(std::string const &aMeasurementSpec) {
     boost::regex spec(aMeasurementSpec);
+    theReducedNodeSpecs.push_back(aMeasurementSpec);
     measurement_collection selected_measurements;
     for (auto &aMeasurement : theMeasurements)
       if (boost::regex_match(aMeasurement.first, spec))
@@ -906,6 +946,9 @@ public:
   void listMeasurements(std::ostream &anOstream) {
     for (auto &aMeasurement : theMeasurements)
       anOstream << *aMeasurement.second << std::endl;
+    for (uint32_t i = 0; i < theRegions.regions(); ++i)
+      if (theMeasurements.count(theRegions.regionName(i)) == 0)
+        anOstream << theRegions.regionName(i) << std::endl;
     // measurement_collection::iterator iter = theMeasurements.begin();
     // measurement_collection::iterator end = theMeasurements.end();
     // while (iter != end) {
@@ -932,10 +975,10 @@ public:
 
   void printMeasurement(std::string const &aMeasurementSpec, std::ostream &anOstream) {
     boost::regex spec(aMeasurementSpec);
+    measurement_collection selected(selectMeasurements(spec));
     std::map<std::string, Measurement *> matches;
-    for (auto &pair : theMeasurements)
-      if (boost::regex_match(pair.first, spec))
-        matches[pair.first] = pair.second.get();
+    for (auto &pair : selected)
+      matches[pair.first] = pair.second.get();
     // measurement_collection::iterator iter = theMeasurements.begin();
     // measurement_collection::iterator end = theMeasurements.end();
     // while (iter != end) {
@@ -961,10 +1004,10 @@ public:
               std::ostream &anOstream) {
     boost::regex spec(aMeasurementSpec);
 
+    measurement_collection selected(selectMeasurements(spec));
     std::map<std::string, Measurement *> matches;
-    for (auto &pair : theMeasurements)
-      if (boost::regex_match(pair.first, spec))
-        matches[pair.first] = pair.second.get();
+    for (auto &pair : selected)
+      matches[pair.first] = pair.second.get();
     // measurement_collection::iterator iter = theMeasurements.begin();
     // measurement_collection::iterator end = theMeasurements.end();
     // while (iter != end) {
@@ -984,10 +1027,10 @@ public:
   void formatFile(std::string const &aMeasurementSpec, std::string const &aFile,
                   std::ostream &anOstream) {
     boost::regex spec(aMeasurementSpec);
+    measurement_collection selected(selectMeasurements(spec));
     std::map<std::string, Measurement *> matches;
-    for (auto &pair : theMeasurements)
-      if (boost::regex_match(pair.first, spec))
-        matches[pair.first] = pair.second.get();
+    for (auto &pair : selected)
+      matches[pair.first] = pair.second.get();
     // measurement_collection::iterator iter = theMeasurements.begin();
     // measurement_collection::iterator end = theMeasurements.end();
     // while (iter != end) {
@@ -1015,10 +1058,10 @@ public:
   void collapse(std::string const &aMeasurementSpec, std::string const &aFormat,
                 std::ostream &anOstream) {
     boost::regex spec(aMeasurementSpec);
+    measurement_collection selected(selectMeasurements(spec));
     std::map<std::string, Measurement *> matches;
-    for (auto &pair : theMeasurements)
-      if (boost::regex_match(pair.first, spec))
-        matches[pair.first] = pair.second.get();
+    for (auto &pair : selected)
+      matches[pair.first] = pair.second.get();
     // measurement_collection::iterator iter = theMeasurements.begin();
     // measurement_collection::iterator end = theMeasurements.end();
     // while (iter != end) {
@@ -1044,10 +1087,10 @@ public:
   void reduce(eReduction aReduction, std::string const &aMeasurementSpec,
               std::string const &aDestMeasurement, std::ostream &anOstream) {
     boost::regex spec(aMeasurementSpec);
+    measurement_collection selected(selectMeasurements(spec));
     std::map<std::string, Measurement *> matches;
-    for (auto &pair : theMeasurements)
-      if (boost::regex_match(pair.first, spec))
-        matches[pair.first] = pair.second.get();
+    for (auto &pair : selected)
+      matches[pair.first] = pair.second.get();
     // measurement_collection::iterator iter = theMeasurements.begin();
     // measurement_collection::iterator end = theMeasurements.end();
     // while (iter != end) {
@@ -1069,10 +1112,10 @@ public:
   void collapseFile(std::string const &aMeasurementSpec, std::string const &aFile,
                     std::ostream &anOstream) {
     boost::regex spec(aMeasurementSpec);
+    measurement_collection selected(selectMeasurements(spec));
     std::map<std::string, Measurement *> matches;
-    for (auto &pair : theMeasurements)
-      if (boost::regex_match(pair.first, spec))
-        matches[pair.first] = pair.second.get();
+    for (auto &pair : selected)
+      matches[pair.first] = pair.second.get();
     // measurement_collection::iterator iter = theMeasurements.begin();
     // measurement_collection::iterator end = theMeasurements.end();
     // while (iter != end) {
@@ -1105,10 +1148,7 @@ public:
 
   void saveMeasurements(std::string const &aMeasurementSpec, std::string const &aFile) const {
     boost::regex spec(aMeasurementSpec);
-    measurement_collection selected_measurements;
-    for (auto &pair : theMeasurements)
-      if (boost::regex_match(pair.first, spec))
-        selected_measurements.insert(pair);
+    measurement_collection selected_measurements(selectMeasurements(spec));
     // measurement_collection::const_iterator iter = theMeasurements.begin();
     // measurement_collection::const_iterator end = theMeasurements.end();
     // while (iter != end) {
@@ -1173,6 +1213,13 @@ public:
     theEventQueue.push(evt);
   }
 
+  int64_t nextEventTick() {
+    if (theEventQueue.empty()) {
+      return std::numeric_limits<int64_t>::max();
+    }
+    return theEventQueue.top().theDeadline;
+  }
+
   template <class Archive> void register_types(Archive &ar) const {
     // Only add to the bottom of this list of types
     ar.template register_type<SimpleMeasurement>();
@@ -1209,6 +1256,17 @@ public:
     oa << theStatNames;
     oa << theMeasurements;
     oa << theTick;
+    oa << theRegions;
+  }
+
+  // Databases written before regions were recorded as a series end after the
+  // tick, and carry their regions as ordinary measurements.
+  void loadRegions(boost::archive::binary_iarchive &ia, RegionSeries &aRegions) {
+    try {
+      ia >> aRegions;
+    } catch (boost::archive::archive_exception &anException) {
+      aRegions.clear();
+    }
   }
 
   void load(std::istream &anIstream) {
@@ -1219,6 +1277,7 @@ public:
     ia >> theStatNames;
     ia >> theMeasurements;
     ia >> theTick;
+    loadRegions(ia, theRegions);
   }
 
   void loadMore(std::istream &anIstream, std::string const &aPrefix) {
@@ -1233,6 +1292,15 @@ public:
     ia >> measurements;
     ia >> tick;
 
+    RegionSeries regions;
+    loadRegions(ia, regions);
+    std::set<uint32_t> all_regions;
+    for (uint32_t i = 0; i < regions.regions(); ++i)
+      all_regions.insert(i);
+    for (auto &region : regions.materialize(all_regions))
+      if (measurements.count(region->name()) == 0)
+        measurements[region->name()] = region;
+
     for (auto &aMeasurement : measurements) {
       auto name = aPrefix + aMeasurement.second->name();
       aMeasurement.second->resetName(name);
@@ -0,0 +1,106 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#ifndef FLEXUS_CORE_TEST_QEMU_STUB_HOOKS_HPP_INCLUDED
+#define FLEXUS_CORE_TEST_QEMU_STUB_HOOKS_HPP_INCLUDED
+
+#include <core/qemu/mai_api.hpp>
+
+// Local stand-ins for the QEMU hooks the Processor wrapper calls, so that it
+// can be exercised without QEMU.  The stub cpu executes instructions in order
+// and raises theException on instruction number theRaiseAt (counting from 1).
+namespace StubQemu {
+
+namespace API = Flexus::Qemu::API;
+
+struct StubCPU {
+  int theExecuted;
+  int theRaiseAt;
+  int theException;
+  int theCalls;
+};
+
+inline StubCPU &theCPU() {
+  static StubCPU cpu;
+  return cpu;
+}
+
+inline int executeOne() {
+  ++theCPU().theExecuted;
+  return theCPU().theExecuted == theCPU().theRaiseAt ? theCPU().theException : 0;
+}
+
+inline int get_cpu_index(API::conf_object_t *) {
+  return 0;
+}
+
+inline int cpu_execute(API::conf_object_t *) {
+  ++theCPU().theCalls;
+  return executeOne();
+}
+
+inline int cpu_execute_n(API::conf_object_t *, int aCount, int *anExecuted) {
+  ++theCPU().theCalls;
+  int exception = 0;
+  for (*anExecuted = 0; *anExecuted < aCount && exception == 0; ++*anExecuted) {
+    exception = executeOne();
+  }
+  return exception;
+}
+
+// Installs the stub hooks, with or without the batched execute hook, and
+// resets the stub cpu
+inline void install(bool aBatched, int aRaiseAt = 0, int anException = 0) {
+  API::QEMU_get_cpu_index = &get_cpu_index;
+  API::QEMU_cpu_execute = &cpu_execute;
+  API::QEMU_cpu_execute_n = aBatched ? &cpu_execute_n : nullptr;
+  theCPU().theExecuted = 0;
+  theCPU().theRaiseAt = aRaiseAt;
+  theCPU().theException = anException;
+  theCPU().theCalls = 0;
+}
+
+} // namespace StubQemu
+
+#endif // FLEXUS_CORE_TEST_QEMU_STUB_HOOKS_HPP_INCLUDED
@@ -0,0 +1,144 @@
+//  DO-NOT-REMOVE begin-copyright-block
+// QFlex consists of several software components that are governed by various
+// licensing terms, in addition to software that was developed internally.
+// Anyone interested in using QFlex needs to fully understand and abide by the
+// licenses governing all the software components.
+//
+// ### Software developed externally (not by the QFlex group)
+//
+//     * [NS-3] (https://www.gnu.org/copyleft/gpl.html)
+//     * [QEMU] (http://wiki.qemu.org/License)
+//     * [SimFlex] (http://parsa.epfl.ch/simflex/)
+//     * [GNU PTH] (https://www.gnu.org/software/pth/)
+//
+// ### Software developed internally (by the QFlex group)
+// **QFlex License**
+//
+// QFlex
+// Copyright (c) 2020, Parallel Systems Architecture Lab, EPFL
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of the Parallel Systems Architecture Laboratory, EPFL,
+//       nor the names of its contributors may be used to endorse or promote
+//       products derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE PARALLEL SYSTEMS ARCHITECTURE LABORATORY,
+// EPFL BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//  DO-NOT-REMOVE end-copyright-block
+#include <boost/test/unit_test.hpp>
+
+#include <components/uArchARM/CommitBatch.hpp>
+#include <core/test/qemu_stub_hooks.hpp>
+
+#include <functional>
+#include <vector>
+
+using namespace boost::unit_test_framework;
+using nuArchARM::CommitBatch;
+
+namespace {
+
+Flexus::Qemu::API::conf_object_t theStubObject = {};
+
+struct Retired {
+  std::vector<int> theInsns;
+  std::vector<bool> theRaised;
+  void operator()(int anInsn, bool aRaised) {
+    theInsns.push_back(anInsn);
+    theRaised.push_back(aRaised);
+  }
+};
+
+void fill(CommitBatch<int> &aBatch, int aCount) {
+  for (int i = 0; i < aCount; ++i) {
+    aBatch.push(i);
+  }
+}
+
+void testDrainRetiresWholeBatch() {
+  StubQemu::install(true);
+  Flexus::Qemu::Processor cpu(&theStubObject);
+  CommitBatch<int> batch;
+  fill(batch, 4);
+
+  Retired retired;
+  int raised = batch.drain(
+      [&cpu](int32_t aCount, int32_t &anExecuted) { return cpu->advance(aCount, anExecuted); },
+      std::ref(retired));
+
+  BOOST_CHECK_EQUAL(raised, 0);
+  BOOST_CHECK(batch.empty());
+  BOOST_CHECK_EQUAL(retired.theInsns.size(), 4u);
+  for (size_t i = 0; i < retired.theInsns.size(); ++i) {
+    BOOST_CHECK_EQUAL(retired.theInsns[i], static_cast<int>(i));
+    BOOST_CHECK(!retired.theRaised[i]);
+  }
+  BOOST_CHECK_EQUAL(StubQemu::theCPU().theCalls, 1);
+}
+
+void testDrainRetiresExecutedPrefix() {
+  StubQemu::install(true, 3, 0x42);
+  Flexus::Qemu::Processor cpu(&theStubObject);
+  CommitBatch<int> batch;
+  fill(batch, 6);
+
+  Retired retired;
+  int raised = batch.drain(
+      [&cpu](int32_t aCount, int32_t &anExecuted) { return cpu->advance(aCount, anExecuted); },
+      std::ref(retired));
+
+  // The instructions after the one that raised never committed
+  BOOST_CHECK_EQUAL(raised, 0x42);
+  BOOST_CHECK(batch.empty());
+  BOOST_CHECK_EQUAL(retired.theInsns.size(), 3u);
+  BOOST_CHECK_EQUAL(retired.theInsns.back(), 2);
+  BOOST_CHECK(!retired.theRaised[0]);
+  BOOST_CHECK(!retired.theRaised[1]);
+  BOOST_CHECK(retired.theRaised[2]);
+}
+
+void testDrainSteppedMatchesBatched() {
+  StubQemu::install(false, 2, 0x42);
+  Flexus::Qemu::Processor cpu(&theStubObject);
+  CommitBatch<int> batch;
+  fill(batch, 5);
+
+  Retired retired;
+  int raised = batch.drain(
+      [&cpu](int32_t aCount, int32_t &anExecuted) { return cpu->advance(aCount, anExecuted); },
+      std::ref(retired));
+
+  BOOST_CHECK_EQUAL(raised, 0x42);
+  BOOST_CHECK_EQUAL(retired.theInsns.size(), 2u);
+  BOOST_CHECK(retired.theRaised[1]);
+  BOOST_CHECK_EQUAL(StubQemu::theCPU().theExecuted, 2);
+}
+
+} // namespace
+
+test_suite *commit_batch_test_suite() {
+  test_suite *test = BOOST_TEST_SUITE("Commit batch unit test");
+
+  test->add(BOOST_TEST_CASE(&testDrainRetiresWholeBatch));
+  test->add(BOOST_TEST_CASE(&testDrainRetiresExecutedPrefix));
+  test->add(BOOST_TEST_CASE(&testDrainSteppedMatchesBatched));
+
+  return test;
+}
@@ -42,12 +42,14 @@
 // LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //  DO-NOT-REMOVE end-copyright-block
+// Boost.Test comes first: the colour macros of the debug headers clash with
+// its terminal attributes
+#include <boost/test/included/unit_test_framework.hpp>
+
 #include <core/debug/debug.hpp>
 
 #define FLEXUS_internal_COMP_DEBUG_SEV DBG_internal_Sev_to_int(Dev)
 
-#include <boost/test/included/unit_test_framework.hpp>
-
 namespace Flexus {
 namespace Core {
 void Break() {
@@ -57,10 +59,16 @@ void Break() {
 
 using namespace boost::unit_test_framework;
 
+test_suite *processor_advance_test_suite();
+test_suite *commit_batch_test_suite();
+
 test_suite *init_unit_test_suite(int32_t argc, char *argv[]) {
   test_suite *test = BOOST_TEST_SUITE("Flexus core unit tests");
 
   DBG_(Dev, Core()(<< "Beginning Regression tests."));
 
+  test->add(processor_advance_test_suite());
+  test->add(commit_batch_test_suite());
+
   return test;
 }
@@ -148,6 +148,13 @@ public:
   ~Transport() {
   }
 
+  // The user-declared destructor suppresses the implicit move operations;
+  // restore them so queues can hand transports over without refcount traffic.
+  Transport(Transport const &) = default;
+  Transport(Transport &&) = default;
+  Transport &operator=(Transport const &) = default;
+  Transport &operator=(Transport &&) = default;
+
   using base::operator[];
   using base::set;
 